@@ -0,0 +1,7 @@
+-- empty update of the Scripting benchmark, measures the cost of calling into lua and nothing else
+BenchEmpty = {}
+
+function BenchEmpty.OnUpdate(self, ts)
+end
+
+return BenchEmpty
@@ -0,0 +1,15 @@
+-- script used by the headless scene benchmark, keep it cheap but representative
+BenchEntity = {}
+
+function BenchEntity.OnCreate(self)
+	self.time = 0
+end
+
+function BenchEntity.OnUpdate(self, ts)
+	self.time = self.time + ts
+
+	local transform = self.owner:get(Transform)
+	transform.translation.y = math.sin(self.time)
+end
+
+return BenchEntity
@@ -0,0 +1,8 @@
+-- script without OnUpdate (e.g. a trigger that only reacts to events), the scene skips it every frame
+BenchNoUpdate = {}
+
+function BenchNoUpdate.OnCreate(self)
+	self.created = true
+end
+
+return BenchNoUpdate
@@ -0,0 +1,25 @@
+-- bench_npc.lua as a system style script: one OnUpdateAll call per frame moves every NPC of the crowd
+BenchNpc = {}
+
+function BenchNpc.OnCreate(self)
+	local transform = self.owner:get(Transform)
+	self.time = 0
+	self.homeX = transform.translation.x
+	self.homeZ = transform.translation.z
+	self.phase = (self.homeX * 0.37 + self.homeZ * 0.11) % 6.28
+end
+
+function BenchNpc.OnUpdateAll(entities, ts)
+	for i = 1, #entities do
+		local self = entities:instance(i)
+		self.time = self.time + ts
+
+		local t = self.time + self.phase
+		entities:setPosition(i,
+			self.homeX + math.cos(t) * 2.0 + math.sin(t * 0.5),
+			math.abs(math.sin(t * 4.0)) * 0.25,
+			self.homeZ + math.sin(t) * 2.0 + math.cos(t * 0.3))
+	end
+end
+
+return BenchNpc
@@ -0,0 +1,22 @@
+-- same NPC as bench_npc.lua, declared parallel safe: updated on the worker lua states, component writes are deferred
+BenchNpc = { Parallel = true }
+
+function BenchNpc.OnCreate(self)
+	local transform = self.owner:get(Transform)
+	self.time = 0
+	self.homeX = transform.translation.x
+	self.homeZ = transform.translation.z
+	self.phase = (self.homeX * 0.37 + self.homeZ * 0.11) % 6.28
+end
+
+function BenchNpc.OnUpdate(self, ts)
+	self.time = self.time + ts
+
+	local t = self.time + self.phase
+	local transform = self.owner:get(Transform)
+	transform.translation.x = self.homeX + math.cos(t) * 2.0 + math.sin(t * 0.5)
+	transform.translation.z = self.homeZ + math.sin(t) * 2.0 + math.cos(t * 0.3)
+	transform.translation.y = math.abs(math.sin(t * 4.0)) * 0.25
+end
+
+return BenchNpc
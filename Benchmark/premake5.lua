@@ -0,0 +1,48 @@
+project "Benchmark"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "on"
+
+    targetdir "%{wks.location}/bin/%{cfg.platform}_%{cfg.buildcfg}/%{prj.name}"
+    --objdir "../bin-int/%{cfg.platform}_%{cfg.buildcfg}"
+
+    -- headless benchmarks, never opens a window or creates a GL context
+    -- run from the Benchmark directory so the relative assets/ path resolves
+
+    files {
+        "src/**.c", 
+        "src/**.cpp", 
+        "src/**.h", 
+        "src/**.hpp"
+    }
+  
+    includedirs { 
+        "src",
+        "%{wks.location}/SpectralEngine/src",
+        "%{wks.location}/SpectralEngine/vendor",
+        "%{IncludeDir.lua}",
+        "%{IncludeDir.sol}",
+        "%{IncludeDir.spdlog}",
+        "%{IncludeDir.entt}",
+        "%{IncludeDir.imgui}",
+        "%{IncludeDir.box2d}",
+        "%{IncludeDir.joltPhysics}"
+    }
+
+    filter "action:xcode4"
+        -- this is required by xcode, means that the header files enclosed in angle brackets
+        -- will search System Header Search Paths and Header Search Paths
+        xcodebuildsettings = { ["ALWAYS_SEARCH_USER_PATHS"] = "YES" }
+        externalincludedirs {
+            "%{IncludeDir.spdlog}",
+            "%{IncludeDir.sol}"
+        }
+
+    filter {}
+    
+    link_raylib()
+
+    links {
+        "SpectralEngine"
+    }
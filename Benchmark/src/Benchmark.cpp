@@ -0,0 +1,95 @@
+//
+//  Benchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "Benchmark.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <ostream>
+
+namespace Spectral::Bench {
+
+    // nearest-rank percentile over sorted samples
+    static double Percentile(const std::vector<double>& sorted, double percentile)
+    {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+
+        size_t rank = (size_t)std::ceil(percentile / 100.0 * (double)sorted.size());
+        rank = std::clamp<size_t>(rank, 1, sorted.size());
+        return sorted[rank - 1];
+    }
+
+    void Report::AddSamples(const std::string& suite, const std::string& phase, uint32_t entities, std::vector<double> samplesMs)
+    {
+        Result result;
+        result.Suite = suite;
+        result.Phase = phase;
+        result.Entities = entities;
+        result.Samples = samplesMs.size();
+
+        if (!samplesMs.empty())
+        {
+            std::sort(samplesMs.begin(), samplesMs.end());
+
+            result.MinMs = samplesMs.front();
+            result.MaxMs = samplesMs.back();
+            result.MeanMs = std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0) / (double)samplesMs.size();
+            result.P50Ms = Percentile(samplesMs, 50.0);
+            result.P99Ms = Percentile(samplesMs, 99.0);
+        }
+
+        m_Results.push_back(result);
+    }
+
+    void Report::WriteJSON(std::ostream& out, const Config& config) const
+    {
+        out << "{\n";
+        out << "  \"frames\": " << config.Frames << ",\n";
+        out << "  \"warmupFrames\": " << config.WarmupFrames << ",\n";
+        out << "  \"runs\": " << config.Runs << ",\n";
+        out << "  \"threads\": " << JobSystem::GetThreadCount() << ",\n";
+        out << "  \"results\": [\n";
+
+        for (size_t i = 0; i < m_Results.size(); i++)
+        {
+            const Result& r = m_Results[i];
+            out << "    {\"suite\": \"" << r.Suite << "\", \"phase\": \"" << r.Phase << "\", \"entities\": " << r.Entities
+                << ", \"samples\": " << r.Samples
+                << ", \"min_ms\": " << r.MinMs
+                << ", \"mean_ms\": " << r.MeanMs
+                << ", \"p50_ms\": " << r.P50Ms
+                << ", \"p99_ms\": " << r.P99Ms
+                << ", \"max_ms\": " << r.MaxMs << "}"
+                << (i + 1 < m_Results.size() ? ",\n" : "\n");
+        }
+
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    void Report::WriteCSV(std::ostream& out) const
+    {
+        out << "suite,phase,entities,samples,min_ms,mean_ms,p50_ms,p99_ms,max_ms\n";
+
+        for (const Result& r : m_Results)
+        {
+            out << r.Suite << "," << r.Phase << "," << r.Entities << "," << r.Samples << ","
+                << r.MinMs << "," << r.MeanMs << "," << r.P50Ms << "," << r.P99Ms << "," << r.MaxMs << "\n";
+        }
+    }
+
+    std::vector<Suite>& GetSuites()
+    {
+        static std::vector<Suite> s_Suites;
+        return s_Suites;
+    }
+}
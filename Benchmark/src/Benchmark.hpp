@@ -0,0 +1,85 @@
+//
+//  Benchmark.hpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Spectral::Bench {
+
+    struct Config
+    {
+        std::vector<uint32_t> EntityCounts = {1'000, 10'000, 100'000};
+        uint32_t Frames = 120;      // timed frames per run
+        uint32_t WarmupFrames = 10; // untimed frames before measuring
+        uint32_t Runs = 3;          // fresh scene per run, start/end phases are sampled once per run
+        uint32_t Threads = 0;       // JobSystem worker threads, 0 = one per hardware thread
+        std::string Suite;          // empty runs every registered suite
+        std::string Format = "json";
+        std::string OutputPath;     // empty writes to stdout
+    };
+
+    struct Result
+    {
+        std::string Suite;
+        std::string Phase;
+        uint32_t Entities = 0;
+
+        size_t Samples = 0;
+        double MinMs = 0.0;
+        double MeanMs = 0.0;
+        double P50Ms = 0.0;
+        double P99Ms = 0.0;
+        double MaxMs = 0.0;
+    };
+
+    // collects raw samples per (suite, phase, entity count) and reduces them to percentiles
+    class Report
+    {
+    public:
+        void AddSamples(const std::string& suite, const std::string& phase, uint32_t entities, std::vector<double> samplesMs);
+
+        void WriteJSON(std::ostream& out, const Config& config) const;
+        void WriteCSV(std::ostream& out) const;
+
+        const std::vector<Result>& GetResults() const { return m_Results; }
+
+    private:
+        std::vector<Result> m_Results;
+    };
+
+    using SuiteFn = std::function<void(const Config&, Report&)>;
+
+    struct Suite
+    {
+        std::string Name;
+        SuiteFn Run;
+    };
+
+    std::vector<Suite>& GetSuites();
+
+    // register a suite from any translation unit: static SuiteRegistrar s_Registrar("name", &Fn);
+    struct SuiteRegistrar
+    {
+        SuiteRegistrar(const std::string& name, SuiteFn fn) { GetSuites().push_back({name, std::move(fn)}); }
+    };
+
+    class Timer
+    {
+    public:
+        Timer() { Reset(); }
+
+        void Reset() { m_Start = std::chrono::steady_clock::now(); }
+        double ElapsedMs() const { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count(); }
+
+    private:
+        std::chrono::steady_clock::time_point m_Start;
+    };
+}
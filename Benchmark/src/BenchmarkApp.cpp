@@ -0,0 +1,127 @@
+//
+//  BenchmarkApp.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Headless benchmark runner, does not create an Application (no window, no GL context).
+//
+//  usage: Benchmark [--suite name] [--entities 1000,10000,100000] [--frames 120] [--warmup 10]
+//                   [--runs 3] [--threads 0] [--format json|csv] [--output path]
+//
+
+#include "Benchmark.hpp"
+
+#include "Core/Log.hpp"
+#include "Core/JobSystem.hpp"
+#include "Physics/PhysicsEngine3D.hpp"
+#include "Scripting/ScriptingEngine.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using namespace Spectral;
+
+static std::vector<uint32_t> ParseCounts(const std::string& value)
+{
+    std::vector<uint32_t> counts;
+    std::stringstream stream(value);
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty()) {
+            counts.push_back((uint32_t)std::stoul(item));
+        }
+    }
+    return counts;
+}
+
+static bool ParseArgs(int argc, const char* argv[], Bench::Config& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument " << arg << std::endl;
+            return false;
+        }
+
+        const std::string value = argv[++i];
+
+        if (arg == "--suite")          config.Suite = value;
+        else if (arg == "--entities")  config.EntityCounts = ParseCounts(value);
+        else if (arg == "--frames")    config.Frames = (uint32_t)std::stoul(value);
+        else if (arg == "--warmup")    config.WarmupFrames = (uint32_t)std::stoul(value);
+        else if (arg == "--runs")      config.Runs = (uint32_t)std::stoul(value);
+        else if (arg == "--threads")   config.Threads = (uint32_t)std::stoul(value);
+        else if (arg == "--format")    config.Format = value;
+        else if (arg == "--output")    config.OutputPath = value;
+        else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (config.Format != "json" && config.Format != "csv") {
+        std::cerr << "Unknown format " << config.Format << " (expected json or csv)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, const char * argv[])
+{
+    Log::init();
+
+    // keep the per-entity engine logs out of the measurements and out of the report on stdout
+    Log::GetCoreLogger()->set_level(spdlog::level::warn);
+    Log::GetClientLogger()->set_level(spdlog::level::warn);
+
+    Bench::Config config;
+    if (!ParseArgs(argc, argv, config)) {
+        return 1;
+    }
+
+    JobSystem::Init(config.Threads);
+    PhysicsEngine3D::Init();
+    ScriptingEngine::Init();
+
+    Bench::Report report;
+    bool suiteFound = false;
+
+    for (const Bench::Suite& suite : Bench::GetSuites())
+    {
+        if (!config.Suite.empty() && config.Suite != suite.Name) {
+            continue;
+        }
+
+        suiteFound = true;
+        std::cerr << "Running benchmark suite: " << suite.Name << std::endl;
+        suite.Run(config, report);
+    }
+
+    if (!suiteFound) {
+        SP_CLIENT_LOG_ERORR("No benchmark suite named ({0})", config.Suite);
+        PhysicsEngine3D::Shutdown();
+        JobSystem::Shutdown();
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!config.OutputPath.empty()) {
+        file.open(config.OutputPath);
+    }
+    std::ostream& out = file.is_open() ? file : std::cout;
+
+    if (config.Format == "csv") {
+        report.WriteCSV(out);
+    } else {
+        report.WriteJSON(out, config);
+    }
+
+    PhysicsEngine3D::Shutdown();
+    JobSystem::Shutdown();
+    return 0;
+}
@@ -0,0 +1,88 @@
+//
+//  Physics2DBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times the 2D runtime update of a tile level: most bodies are static tiles, one in ten is a dynamic
+//  box that falls onto them and goes to sleep. Only the 2D physics world has bodies.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+
+namespace Spectral::Bench {
+
+    static constexpr float s_TileSize = 50.0f; // BoxCollider2DComponent default size
+    static constexpr uint32_t s_DynamicRatio = 10;
+
+    static void PopulateTileLevel(Scene& scene, uint32_t entityCount)
+    {
+        const uint32_t dynamicCount = entityCount / s_DynamicRatio;
+        const uint32_t tileCount = entityCount - dynamicCount;
+        const uint32_t columns = std::max<uint32_t>((uint32_t)std::ceil(std::sqrt((double)tileCount)), 1);
+
+        // tiles are stacked in rows below y = 0
+        for (uint32_t i = 0; i < tileCount; i++)
+        {
+            Entity tile = scene.CreateEntity(UUID(), "Tile");
+            tile.GetComponent<TransformComponent>().Translation = {(float)(i % columns) * s_TileSize, -(float)(i / columns) * s_TileSize, 0.0f};
+
+            tile.AddComponent<RigidBody2DComponent>();
+            tile.AddComponent<BoxCollider2DComponent>();
+        }
+
+        // dynamic boxes above the tiles with a small gap in between, so the rows do not push each other around
+        for (uint32_t i = 0; i < dynamicCount; i++)
+        {
+            Entity box = scene.CreateEntity(UUID(), "Box");
+            box.GetComponent<TransformComponent>().Translation = {(float)(i % columns) * s_TileSize, s_TileSize * 2.0f + (float)(i / columns) * s_TileSize * 1.2f, 0.0f};
+
+            auto& rb2d = box.AddComponent<RigidBody2DComponent>();
+            rb2d.Type = RigidBody2DComponent::BodyType::Dynamic;
+            box.AddComponent<BoxCollider2DComponent>();
+        }
+    }
+
+    static void RunPhysics2DSuite(const Config& config, Report& report)
+    {
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> startSamples;
+            std::vector<double> updateSamples;
+
+            updateSamples.reserve((size_t)config.Frames * config.Runs);
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                auto scene = std::make_unique<Scene>("BenchmarkScene");
+                PopulateTileLevel(*scene, entityCount);
+
+                const float fixedTimestep = scene->GetPhysicsSettings().FixedTimestep;
+
+                Timer timer;
+                scene->OnRuntimeStart();
+                startSamples.push_back(timer.ElapsedMs());
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames; frame++) {
+                    scene->OnUpdateRuntime(fixedTimestep);
+                }
+
+                for (uint32_t frame = 0; frame < config.Frames; frame++)
+                {
+                    timer.Reset();
+                    scene->OnUpdateRuntime(fixedTimestep);
+                    updateSamples.push_back(timer.ElapsedMs());
+                }
+
+                scene->OnRuntimeEnd();
+            }
+
+            report.AddSamples("Physics2D", "OnRuntimeStart", entityCount, std::move(startSamples));
+            report.AddSamples("Physics2D", "OnUpdateRuntime", entityCount, std::move(updateSamples));
+        }
+    }
+
+    static SuiteRegistrar s_Physics2DSuite("Physics2D", &RunPhysics2DSuite);
+}
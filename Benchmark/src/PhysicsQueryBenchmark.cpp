@@ -0,0 +1,103 @@
+//
+//  PhysicsQueryBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times line of sight checks against a 3D level of static crates, the way the AI uses them: a fixed number of
+//  linecasts per frame between random points of the level, once one by one and once as a batch on the workers.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+
+#include <random>
+
+namespace Spectral::Bench {
+
+    static constexpr uint32_t s_QueriesPerFrame = 512;
+    static constexpr float s_CrateSpacing = 4.0f;
+
+    static void PopulateCrateLevel(Scene& scene, uint32_t entityCount)
+    {
+        const uint32_t columns = std::max<uint32_t>((uint32_t)std::ceil(std::sqrt((double)entityCount)), 1);
+
+        for (uint32_t i = 0; i < entityCount; i++)
+        {
+            Entity crate = scene.CreateEntity(UUID(), "Crate");
+            crate.GetComponent<TransformComponent>().Translation = {(float)(i % columns) * s_CrateSpacing, 0.0f, (float)(i / columns) * s_CrateSpacing};
+
+            crate.AddComponent<RigidBody3DComponent>();
+            crate.AddComponent<BoxCollider3DComponent>();
+        }
+    }
+
+    static std::vector<LinecastQuery> MakeQueries(uint32_t entityCount, uint32_t seed)
+    {
+        const float size = std::ceil(std::sqrt((float)entityCount)) * s_CrateSpacing;
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(0.0f, size);
+        std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+
+        // short lines at crate height, most of them blocked by a crate or two
+        std::vector<LinecastQuery> queries(s_QueriesPerFrame);
+        for (LinecastQuery& query : queries)
+        {
+            query.From = {position(rng), 0.5f, position(rng)};
+            query.To = {query.From.x + offset(rng), 0.5f, query.From.z + offset(rng)};
+        }
+        return queries;
+    }
+
+    static void RunPhysicsQuerySuite(const Config& config, Report& report)
+    {
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> singleSamples;
+            std::vector<double> batchSamples;
+
+            singleSamples.reserve((size_t)config.Frames * config.Runs);
+            batchSamples.reserve((size_t)config.Frames * config.Runs);
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                auto scene = std::make_unique<Scene>("BenchmarkScene");
+                PopulateCrateLevel(*scene, entityCount);
+                scene->OnRuntimeStart();
+
+                const PhysicsQuery& physicsQuery = scene->GetPhysicsQuery();
+                std::vector<uint8_t> blocked(s_QueriesPerFrame);
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+                {
+                    const std::vector<LinecastQuery> queries = MakeQueries(entityCount, run * 7919 + frame);
+
+                    Timer timer;
+                    for (size_t i = 0; i < queries.size(); i++) {
+                        blocked[i] = physicsQuery.Linecast(queries[i]) ? 1 : 0;
+                    }
+                    const double singleMs = timer.ElapsedMs();
+
+                    timer.Reset();
+                    physicsQuery.LinecastBatch(queries.data(), blocked.data(), queries.size());
+                    const double batchMs = timer.ElapsedMs();
+
+                    if (frame >= config.WarmupFrames)
+                    {
+                        singleSamples.push_back(singleMs);
+                        batchSamples.push_back(batchMs);
+                    }
+                }
+
+                scene->OnRuntimeEnd();
+            }
+
+            report.AddSamples("PhysicsQuery", "Linecast", entityCount, std::move(singleSamples));
+            report.AddSamples("PhysicsQuery", "LinecastBatch", entityCount, std::move(batchSamples));
+        }
+    }
+
+    static SuiteRegistrar s_PhysicsQuerySuite("PhysicsQuery", &RunPhysicsQuerySuite);
+}
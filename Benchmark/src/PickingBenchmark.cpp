@@ -0,0 +1,163 @@
+//
+//  PickingBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times editor mouse picking (Scene::PickEntity) on a grid of cube models: one ray per frame from an editor like
+//  camera towards a random point of the grid. Every frame also moves 1% of the cubes and rebuilds the render queue,
+//  which updates the bounds BVH incrementally. Meshes are CPU only, nothing is drawn.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+#include "Math/Math.hpp"
+
+#include "raymath.h"
+
+#include <random>
+
+namespace Spectral::Bench {
+
+    static constexpr uint32_t s_MaterialMapCount = MATERIAL_MAP_BRDF + 1;
+    static constexpr float s_CubeSpacing = 2.0f;
+
+    // unit cube as a plain triangle list (no indices, no GPU buffers), enough for bounds and exact ray tests
+    struct PickingCube
+    {
+        float Vertices[36 * 3];
+        unsigned int VertexBuffer = 1;
+        Mesh MeshData = {};
+        MaterialMap Maps[s_MaterialMapCount] = {};
+        Material MaterialData = {};
+        int MeshMaterial = 0;
+        Model ModelData = {};
+
+        PickingCube()
+        {
+            // two triangles per face, corners are indexed by their xyz bits
+            static constexpr int s_Faces[6][4] = {
+                {0, 2, 6, 4}, {1, 5, 7, 3}, // -x, +x
+                {0, 4, 5, 1}, {2, 3, 7, 6}, // -y, +y
+                {0, 1, 3, 2}, {4, 6, 7, 5}  // -z, +z
+            };
+            static constexpr int s_Triangles[6] = {0, 1, 2, 0, 2, 3};
+
+            int vertex = 0;
+            for (const auto& face : s_Faces)
+            {
+                for (int corner : s_Triangles)
+                {
+                    // corner bits: 1 = x, 2 = y, 4 = z
+                    const int bits = face[corner];
+                    Vertices[vertex * 3 + 0] = (bits & 1) ? 0.5f : -0.5f;
+                    Vertices[vertex * 3 + 1] = (bits & 2) ? 0.5f : -0.5f;
+                    Vertices[vertex * 3 + 2] = (bits & 4) ? 0.5f : -0.5f;
+                    vertex++;
+                }
+            }
+
+            MeshData.vertexCount = 36;
+            MeshData.triangleCount = 12;
+            MeshData.vertices = Vertices;
+            MeshData.vboId = &VertexBuffer;
+
+            MaterialData.maps = Maps;
+
+            ModelData.transform = MatrixIdentity();
+            ModelData.meshCount = 1;
+            ModelData.meshes = &MeshData;
+            ModelData.materialCount = 1;
+            ModelData.materials = &MaterialData;
+            ModelData.meshMaterial = &MeshMaterial;
+        }
+    };
+
+    static void RunPickingSuite(const Config& config, Report& report)
+    {
+        PickingCube cube;
+
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> pickSamples;
+            std::vector<double> buildSamples;
+
+            pickSamples.reserve((size_t)config.Frames * config.Runs);
+            buildSamples.reserve((size_t)config.Frames * config.Runs);
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                auto scene = std::make_unique<Scene>("BenchmarkScene");
+
+                const uint32_t gridSize = (uint32_t)std::ceil(std::sqrt((double)entityCount));
+                const float gridExtent = (float)gridSize * s_CubeSpacing;
+
+                std::vector<Entity> entities;
+                entities.reserve(entityCount);
+
+                for (uint32_t i = 0; i < entityCount; i++)
+                {
+                    Entity entity = scene->CreateEntity(UUID(), "BenchCube");
+                    entity.GetComponent<TransformComponent>().Translation = {(float)(i % gridSize) * s_CubeSpacing, 0.0f, (float)(i / gridSize) * s_CubeSpacing};
+                    entity.AddComponent<ModelComponent>().ModelData = cube.ModelData;
+                    entities.push_back(entity);
+                }
+
+                // everything in view, only the bounds and the BVH matter here
+                const Vector3 viewPosition = {gridExtent * 0.5f, gridExtent, -gridExtent * 0.5f};
+                const Matrix view = MatrixLookAt(viewPosition, (Vector3){gridExtent * 0.5f, 0.0f, gridExtent * 0.5f}, (Vector3){0.0f, 1.0f, 0.0f});
+                const Matrix projection = MatrixPerspective(90.0 * DEG2RAD, 16.0 / 9.0, 0.1, gridExtent * 4.0);
+
+                Math::Frustum frustum;
+                Math::ExtractFrustrum(projection, view, &frustum);
+
+                // first build inserts every entity into the BVH
+                scene->OnUpdateEditor(1.0f / 60.0f);
+                scene->BuildRenderQueue(frustum, viewPosition);
+
+                std::mt19937 rng(run + 1);
+                std::uniform_real_distribution<float> target(0.0f, gridExtent);
+                std::uniform_int_distribution<uint32_t> pick(0, entityCount - 1);
+                std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+                const uint32_t movedCount = std::max<uint32_t>(entityCount / 100, 1);
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+                {
+                    // move 1% of the cubes, most moves stay inside the fat box of the leaf, the others are reinserted
+                    for (uint32_t i = 0; i < movedCount; i++)
+                    {
+                        Vector3& translation = entities[pick(rng)].GetComponent<TransformComponent>().Translation;
+                        translation.x += offset(rng);
+                        translation.y += offset(rng);
+                    }
+
+                    Timer timer;
+                    scene->OnUpdateEditor(1.0f / 60.0f);
+                    scene->BuildRenderQueue(frustum, viewPosition);
+                    const double buildMs = timer.ElapsedMs();
+
+                    const Vector3 point = {target(rng), 0.0f, target(rng)};
+                    const Ray ray = {viewPosition, Vector3Normalize(Vector3Subtract(point, viewPosition))};
+
+                    timer.Reset();
+                    RayCollision collision;
+                    scene->PickEntity(ray, collision);
+                    const double pickMs = timer.ElapsedMs();
+
+                    if (frame >= config.WarmupFrames)
+                    {
+                        buildSamples.push_back(buildMs);
+                        pickSamples.push_back(pickMs);
+                    }
+                }
+            }
+
+            report.AddSamples("Picking", "UpdateAndBuildRenderQueue", entityCount, std::move(buildSamples));
+            report.AddSamples("Picking", "PickEntity", entityCount, std::move(pickSamples));
+        }
+    }
+
+    static SuiteRegistrar s_PickingSuite("Picking", &RunPickingSuite);
+}
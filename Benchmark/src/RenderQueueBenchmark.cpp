@@ -0,0 +1,152 @@
+//
+//  RenderQueueBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times the CPU side of the render queue (command submission, radix sort and batching).
+//  Meshes, materials and textures are plain structs that are never uploaded, so no GL context is needed.
+//
+
+#include "Benchmark.hpp"
+
+#include "Renderer/RenderQueue.hpp"
+
+#include "raymath.h"
+
+#include <set>
+
+namespace Spectral::Bench {
+
+    static constexpr uint32_t s_ModelCount = 16; // distinct (mesh, material) pairs shared by all the entities
+    static constexpr uint32_t s_TintCount = 4;
+    static constexpr uint32_t s_SpriteRatio = 4; // every 4th entity is a sprite
+    static constexpr uint32_t s_TransparentRatio = 8; // every 8th model is transparent
+    static constexpr uint32_t s_MaterialMapCount = MATERIAL_MAP_BRDF + 1;
+
+    static bool IsSorted(const RenderQueue& queue)
+    {
+        const std::vector<RenderQueue::Command>& commands = queue.GetCommands();
+        for (size_t i = 1; i < commands.size(); i++)
+        {
+            if (commands[i - 1].Key > commands[i].Key) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static size_t CountOpaqueMeshBatches(const RenderQueue& queue)
+    {
+        size_t count = 0;
+        for (const RenderQueue::Batch& batch : queue.GetBatches())
+        {
+            if (batch.Type == RenderQueue::CommandType::Mesh && !batch.Transparent) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    static void RunRenderQueueSuite(const Config& config, Report& report)
+    {
+        // fake GPU ids, the queue only reads them to build the sort keys
+        std::vector<unsigned int> vertexBuffers(s_ModelCount);
+        std::vector<MaterialMap> materialMaps(s_ModelCount * s_MaterialMapCount);
+        std::vector<Mesh> meshes(s_ModelCount);
+        std::vector<Material> materials(s_ModelCount);
+        std::vector<Texture> textures(s_ModelCount);
+
+        for (uint32_t i = 0; i < s_ModelCount; i++)
+        {
+            vertexBuffers[i] = i + 1;
+            meshes[i].vboId = &vertexBuffers[i];
+
+            materials[i].shader.id = 1 + i % 2;
+            materials[i].maps = &materialMaps[i * s_MaterialMapCount];
+            materials[i].maps[MATERIAL_MAP_DIFFUSE].texture.id = 1 + i % 4;
+
+            textures[i].id = 1 + i;
+        }
+
+        const Color tints[s_TintCount] = { WHITE, RED, GREEN, BLUE };
+
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            // interleave the models and tints, so consecutive submissions never belong to the same batch
+            std::vector<Matrix> transforms(entityCount);
+            for (uint32_t i = 0; i < entityCount; i++) {
+                transforms[i] = MatrixTranslate((float)(i % 1000), 0.0f, (float)(i / 1000));
+            }
+
+            // every opaque (model, tint) pair present in the scene has to end up as exactly one batch, whatever the depth
+            std::set<std::pair<uint32_t, uint32_t>> opaquePairs;
+            for (uint32_t i = 0; i < entityCount; i++)
+            {
+                if (i % s_SpriteRatio != 0 && i % s_TransparentRatio != 1) {
+                    opaquePairs.insert({i % s_ModelCount, (i / s_ModelCount) % s_TintCount});
+                }
+            }
+
+            std::vector<double> submitSamples;
+            std::vector<double> sortSamples;
+
+            submitSamples.reserve((size_t)config.Frames * config.Runs);
+            sortSamples.reserve((size_t)config.Frames * config.Runs);
+
+            bool sorted = true;
+            size_t opaqueBatches = 0;
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                RenderQueue queue;
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+                {
+                    const bool measured = frame >= config.WarmupFrames;
+
+                    Timer timer;
+                    queue.Begin((Vector3){500.0f, 10.0f, -50.0f});
+                    queue.Reserve(entityCount);
+
+                    for (uint32_t i = 0; i < entityCount; i++)
+                    {
+                        const uint32_t model = i % s_ModelCount;
+
+                        if (i % s_SpriteRatio == 0) {
+                            queue.SubmitSprite(textures[model], transforms[i], (Vector4){1.0f, 1.0f, 1.0f, 1.0f}, false);
+                        } else {
+                            queue.SubmitMesh(meshes[model], materials[model], transforms[i], tints[(i / s_ModelCount) % s_TintCount], i % s_TransparentRatio == 1);
+                        }
+                    }
+
+                    if (measured) {
+                        submitSamples.push_back(timer.ElapsedMs());
+                    }
+
+                    timer.Reset();
+                    queue.Sort();
+
+                    if (measured) {
+                        sortSamples.push_back(timer.ElapsedMs());
+                    }
+                }
+
+                sorted &= IsSorted(queue);
+                opaqueBatches = CountOpaqueMeshBatches(queue);
+            }
+
+            if (!sorted) {
+                std::cerr << "RenderQueue: commands are not sorted by key" << std::endl;
+            }
+            if (opaqueBatches != opaquePairs.size()) {
+                std::cerr << "RenderQueue: expected " << opaquePairs.size() << " opaque batches, got " << opaqueBatches << std::endl;
+            }
+
+            report.AddSamples("RenderQueue", "Submit", entityCount, std::move(submitSamples));
+            report.AddSamples("RenderQueue", "Sort", entityCount, std::move(sortSamples));
+        }
+    }
+
+    static SuiteRegistrar s_RenderQueueSuite("RenderQueue", &RunRenderQueueSuite);
+}
@@ -0,0 +1,121 @@
+//
+//  SceneBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times Scene::OnRuntimeStart, OnUpdateRuntime and OnRuntimeEnd on a synthetic scene.
+//  Entities are split evenly between 3D bodies, 2D bodies and Lua scripted entities,
+//  no sprites or models are created so the scene never touches the GPU.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+
+namespace Spectral::Bench {
+
+    static const char* s_ScriptPath = "assets/bench_entity.lua";
+    static constexpr float s_FixedTimestep = 1.0f / 60.0f;
+
+    static void PopulateScene(Scene& scene, uint32_t entityCount)
+    {
+        // static ground for both physics worlds, so bodies land and eventually go to sleep
+        {
+            Entity ground = scene.CreateEntity(UUID(), "Ground3D");
+            ground.GetComponent<TransformComponent>().Scale = {10'000.0f, 1.0f, 10'000.0f};
+            ground.AddComponent<RigidBody3DComponent>();
+            ground.AddComponent<BoxCollider3DComponent>();
+        }
+        {
+            Entity ground = scene.CreateEntity(UUID(), "Ground2D");
+            ground.GetComponent<TransformComponent>().Scale = {10'000.0f, 1.0f, 1.0f};
+            ground.AddComponent<RigidBody2DComponent>();
+            ground.AddComponent<BoxCollider2DComponent>();
+        }
+
+        const uint32_t gridSize = (uint32_t)std::ceil(std::sqrt((double)entityCount));
+
+        for (uint32_t i = 0; i < entityCount; i++)
+        {
+            Entity entity = scene.CreateEntity(UUID(), "BenchEntity");
+            auto& transform = entity.GetComponent<TransformComponent>();
+
+            const float column = (float)(i % gridSize);
+            const float row = (float)(i / gridSize);
+
+            switch (i % 3)
+            {
+                case 0: // 3D body
+                {
+                    transform.Translation = {column * 3.0f, 5.0f + (float)(i % 7), row * 3.0f};
+
+                    auto& rb3d = entity.AddComponent<RigidBody3DComponent>();
+                    rb3d.Type = RigidBody3DComponent::BodyType::Dynamic;
+                    entity.AddComponent<BoxCollider3DComponent>();
+                    break;
+                }
+                case 1: // 2D body
+                {
+                    transform.Translation = {column * 60.0f, 100.0f + row * 60.0f, 0.0f};
+
+                    auto& rb2d = entity.AddComponent<RigidBody2DComponent>();
+                    rb2d.Type = RigidBody2DComponent::BodyType::Dynamic;
+                    entity.AddComponent<BoxCollider2DComponent>();
+                    break;
+                }
+                default: // Lua scripted entity
+                {
+                    transform.Translation = {column, 0.0f, row};
+
+                    auto& lsc = entity.AddComponent<LuaScriptComponent>();
+                    lsc.ScriptPath = s_ScriptPath;
+                    break;
+                }
+            }
+        }
+    }
+
+    static void RunSceneSuite(const Config& config, Report& report)
+    {
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> startSamples;
+            std::vector<double> updateSamples;
+            std::vector<double> endSamples;
+
+            updateSamples.reserve((size_t)config.Frames * config.Runs);
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                auto scene = std::make_unique<Scene>("BenchmarkScene");
+                PopulateScene(*scene, entityCount);
+
+                Timer timer;
+                scene->OnRuntimeStart();
+                startSamples.push_back(timer.ElapsedMs());
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames; frame++) {
+                    scene->OnUpdateRuntime(s_FixedTimestep);
+                }
+
+                for (uint32_t frame = 0; frame < config.Frames; frame++)
+                {
+                    timer.Reset();
+                    scene->OnUpdateRuntime(s_FixedTimestep);
+                    updateSamples.push_back(timer.ElapsedMs());
+                }
+
+                timer.Reset();
+                scene->OnRuntimeEnd();
+                endSamples.push_back(timer.ElapsedMs());
+            }
+
+            report.AddSamples("Scene", "OnRuntimeStart", entityCount, std::move(startSamples));
+            report.AddSamples("Scene", "OnUpdateRuntime", entityCount, std::move(updateSamples));
+            report.AddSamples("Scene", "OnRuntimeEnd", entityCount, std::move(endSamples));
+        }
+    }
+
+    static SuiteRegistrar s_SceneSuite("Scene", &RunSceneSuite);
+}
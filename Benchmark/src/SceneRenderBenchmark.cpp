@@ -0,0 +1,113 @@
+//
+//  SceneRenderBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times Scene::BuildRenderQueue (bounds update, frustum culling, command recording, merge and sort)
+//  in headless mode. Models are built from CPU side meshes that are never uploaded, nothing is drawn.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+#include "Math/Math.hpp"
+
+#include "raymath.h"
+
+namespace Spectral::Bench {
+
+    static constexpr uint32_t s_ModelCount = 8;
+    static constexpr uint32_t s_MaterialMapCount = MATERIAL_MAP_BRDF + 1;
+
+    // unit cube without any GPU buffers, enough for bounds and sort keys
+    struct HeadlessModel
+    {
+        float Vertices[8 * 3];
+        unsigned int VertexBuffer = 0;
+        Mesh MeshData = {};
+        MaterialMap Maps[s_MaterialMapCount] = {};
+        Material MaterialData = {};
+        int MeshMaterial = 0;
+        Model ModelData = {};
+
+        void Init(unsigned int id)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                Vertices[i * 3 + 0] = (i & 1) ? 0.5f : -0.5f;
+                Vertices[i * 3 + 1] = (i & 2) ? 0.5f : -0.5f;
+                Vertices[i * 3 + 2] = (i & 4) ? 0.5f : -0.5f;
+            }
+
+            VertexBuffer = id;
+            MeshData.vertexCount = 8;
+            MeshData.vertices = Vertices;
+            MeshData.vboId = &VertexBuffer;
+
+            MaterialData.maps = Maps;
+
+            ModelData.transform = MatrixIdentity();
+            ModelData.meshCount = 1;
+            ModelData.meshes = &MeshData;
+            ModelData.materialCount = 1;
+            ModelData.materials = &MaterialData;
+            ModelData.meshMaterial = &MeshMaterial;
+        }
+    };
+
+    static void RunSceneRenderSuite(const Config& config, Report& report)
+    {
+        std::vector<HeadlessModel> models(s_ModelCount);
+        for (uint32_t i = 0; i < s_ModelCount; i++) {
+            models[i].Init(i + 1);
+        }
+
+        // camera at the corner of the grid looking along its diagonal, roughly half of the entities are visible
+        const Vector3 viewPosition = {-10.0f, 20.0f, -10.0f};
+        const Matrix view = MatrixLookAt(viewPosition, (Vector3){100.0f, 0.0f, 100.0f}, (Vector3){0.0f, 1.0f, 0.0f});
+        const Matrix projection = MatrixPerspective(60.0 * DEG2RAD, 16.0 / 9.0, 0.1, 1000.0);
+
+        Math::Frustum frustum;
+        Math::ExtractFrustrum(projection, view, &frustum);
+
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> buildSamples;
+            buildSamples.reserve((size_t)config.Frames * config.Runs);
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                auto scene = std::make_unique<Scene>("BenchmarkScene");
+
+                const uint32_t gridSize = (uint32_t)std::ceil(std::sqrt((double)entityCount));
+
+                for (uint32_t i = 0; i < entityCount; i++)
+                {
+                    Entity entity = scene->CreateEntity(UUID(), "BenchModel");
+                    entity.GetComponent<TransformComponent>().Translation = {(float)(i % gridSize) * 2.0f, 0.0f, (float)(i / gridSize) * 2.0f};
+
+                    auto& model = entity.AddComponent<ModelComponent>();
+                    model.ModelData = models[i % s_ModelCount].ModelData;
+                    model.Transparency = (i % 16) == 0;
+                }
+
+                scene->OnUpdateEditor(1.0f / 60.0f);
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+                {
+                    Timer timer;
+                    scene->BuildRenderQueue(frustum, viewPosition);
+
+                    if (frame >= config.WarmupFrames) {
+                        buildSamples.push_back(timer.ElapsedMs());
+                    }
+                }
+            }
+
+            report.AddSamples("SceneRender", "BuildRenderQueue", entityCount, std::move(buildSamples));
+        }
+    }
+
+    static SuiteRegistrar s_SceneRenderSuite("SceneRender", &RunSceneRenderSuite);
+}
@@ -0,0 +1,221 @@
+//
+//  ScriptingBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Times the Lua script update of a crowd of scripted NPCs, nothing else is in the scene (no bodies, no sprites).
+//  The same NPC script runs once on the main lua state, once declared parallel safe, on the worker lua states, and once
+//  as a system style script that updates the whole crowd in a single OnUpdateAll(entities, ts) call. The typed variant
+//  reads the transform through entity:transform() instead of entity:get(Transform).
+//  The GC phases run the serial crowd (every component access creates garbage) with each collector mode: the p99 and max
+//  columns of the update show the collection spikes, the LuaGC phases the collector time at the end of the frame.
+//  The call phases measure the per call overhead with an empty OnUpdate (e.g. `--entities 10000`): the cached function
+//  references of the LuaScriptComponent against the table lookups every script used to do per frame.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+#include "Scripting/ScriptingEngine.hpp"
+
+namespace Spectral::Bench {
+
+    static const char* s_SerialScriptPath = "assets/bench_npc.lua";
+    static const char* s_ParallelScriptPath = "assets/bench_npc_parallel.lua";
+    static const char* s_BatchedScriptPath = "assets/bench_npc_batched.lua";
+    static const char* s_TypedScriptPath = "assets/bench_npc_typed.lua";
+    static const char* s_EmptyScriptPath = "assets/bench_empty.lua";
+    static const char* s_NoUpdateScriptPath = "assets/bench_no_update.lua";
+    static constexpr float s_FixedTimestep = 1.0f / 60.0f;
+
+    static std::vector<Entity> PopulateCrowd(Scene& scene, uint32_t entityCount, const char* scriptPath)
+    {
+        std::vector<Entity> entities;
+        entities.reserve(entityCount);
+
+        const uint32_t gridSize = std::max<uint32_t>((uint32_t)std::ceil(std::sqrt((double)entityCount)), 1);
+
+        for (uint32_t i = 0; i < entityCount; i++)
+        {
+            Entity entity = scene.CreateEntity(UUID(), "BenchNpc");
+            entity.GetComponent<TransformComponent>().Translation = {(float)(i % gridSize) * 4.0f, 0.0f, (float)(i / gridSize) * 4.0f};
+            entity.AddComponent<LuaScriptComponent>().ScriptPath = scriptPath;
+            entities.push_back(entity);
+        }
+        return entities;
+    }
+
+    static void RunCrowd(const Config& config, Report& report, uint32_t entityCount, const char* scriptPath, const char* startPhase, const char* updatePhase)
+    {
+        std::vector<double> startSamples;
+        std::vector<double> samples;
+        samples.reserve((size_t)config.Frames * config.Runs);
+
+        for (uint32_t run = 0; run < config.Runs; run++)
+        {
+            auto scene = std::make_unique<Scene>("BenchmarkScene");
+            PopulateCrowd(*scene, entityCount, scriptPath);
+
+            // every instance runs the chunk of the script cache, the file is only compiled by the first run
+            Timer startTimer;
+            scene->OnRuntimeStart();
+            startSamples.push_back(startTimer.ElapsedMs());
+
+            for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+            {
+                Timer timer;
+                scene->OnUpdateRuntime(s_FixedTimestep);
+                const double updateMs = timer.ElapsedMs();
+
+                if (frame >= config.WarmupFrames) {
+                    samples.push_back(updateMs);
+                }
+            }
+
+            scene->OnRuntimeEnd();
+        }
+
+        report.AddSamples("Scripting", startPhase, entityCount, std::move(startSamples));
+        report.AddSamples("Scripting", updatePhase, entityCount, std::move(samples));
+    }
+
+    // the update as it was before the function references were cached: owner assignment and OnUpdate lookup on every call
+    static void UpdateWithTableLookup(Entity entity, float ts)
+    {
+        auto& lsc = entity.GetComponent<LuaScriptComponent>();
+        lsc.self["owner"] = std::ref(entity);
+
+        sol::protected_function update = lsc.self["OnUpdate"];
+        if (update.valid()) {
+            update(lsc.self, ts);
+        }
+    }
+
+    static void RunCallOverhead(const Config& config, Report& report, uint32_t entityCount)
+    {
+        std::vector<double> lookupSamples;
+        std::vector<double> cachedSamples;
+        std::vector<double> skippedSamples;
+
+        lookupSamples.reserve((size_t)config.Frames * config.Runs);
+        cachedSamples.reserve((size_t)config.Frames * config.Runs);
+        skippedSamples.reserve((size_t)config.Frames * config.Runs);
+
+        for (uint32_t run = 0; run < config.Runs; run++)
+        {
+            auto scene = std::make_unique<Scene>("BenchmarkScene");
+            const std::vector<Entity> entities = PopulateCrowd(*scene, entityCount, s_EmptyScriptPath);
+            scene->OnRuntimeStart();
+
+            for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+            {
+                Timer timer;
+                for (Entity entity : entities) {
+                    UpdateWithTableLookup(entity, s_FixedTimestep);
+                }
+                const double lookupMs = timer.ElapsedMs();
+
+                timer.Reset();
+                for (Entity entity : entities) {
+                    ScriptingEngine::OnUpdate(entity, s_FixedTimestep);
+                }
+                const double cachedMs = timer.ElapsedMs();
+
+                if (frame >= config.WarmupFrames)
+                {
+                    lookupSamples.push_back(lookupMs);
+                    cachedSamples.push_back(cachedMs);
+                }
+            }
+
+            scene->OnRuntimeEnd();
+        }
+
+        // scripts without OnUpdate, the whole scene update
+        for (uint32_t run = 0; run < config.Runs; run++)
+        {
+            auto scene = std::make_unique<Scene>("BenchmarkScene");
+            PopulateCrowd(*scene, entityCount, s_NoUpdateScriptPath);
+            scene->OnRuntimeStart();
+
+            for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+            {
+                Timer timer;
+                scene->OnUpdateRuntime(s_FixedTimestep);
+                const double updateMs = timer.ElapsedMs();
+
+                if (frame >= config.WarmupFrames) {
+                    skippedSamples.push_back(updateMs);
+                }
+            }
+
+            scene->OnRuntimeEnd();
+        }
+
+        report.AddSamples("Scripting", "EmptyCallTableLookup", entityCount, std::move(lookupSamples));
+        report.AddSamples("Scripting", "EmptyCallCached", entityCount, std::move(cachedSamples));
+        report.AddSamples("Scripting", "OnUpdateRuntimeNoUpdate", entityCount, std::move(skippedSamples));
+    }
+
+    static void RunGarbageCollector(const Config& config, Report& report, uint32_t entityCount, ScriptingEngine::GCMode mode, const char* updatePhase, const char* gcPhase)
+    {
+        const ScriptingEngine::GCSettings defaultSettings = ScriptingEngine::GetGCSettings();
+        
+        ScriptingEngine::GCSettings settings = defaultSettings;
+        settings.Mode = mode;
+        ScriptingEngine::SetGCSettings(settings);
+        
+        std::vector<double> samples;
+        std::vector<double> gcSamples;
+        samples.reserve((size_t)config.Frames * config.Runs);
+        gcSamples.reserve((size_t)config.Frames * config.Runs);
+        
+        for (uint32_t run = 0; run < config.Runs; run++)
+        {
+            auto scene = std::make_unique<Scene>("BenchmarkScene");
+            PopulateCrowd(*scene, entityCount, s_SerialScriptPath);
+            scene->OnRuntimeStart();
+            
+            for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+            {
+                Timer timer;
+                scene->OnUpdateRuntime(s_FixedTimestep);
+                const double updateMs = timer.ElapsedMs();
+                
+                if (frame >= config.WarmupFrames)
+                {
+                    samples.push_back(updateMs);
+                    gcSamples.push_back(ScriptingEngine::GetGCStats().TimeMs);
+                }
+            }
+            
+            scene->OnRuntimeEnd();
+        }
+        
+        ScriptingEngine::SetGCSettings(defaultSettings);
+        
+        report.AddSamples("Scripting", updatePhase, entityCount, std::move(samples));
+        if (mode != ScriptingEngine::GCMode::Automatic) {
+            report.AddSamples("Scripting", gcPhase, entityCount, std::move(gcSamples));
+        }
+    }
+
+    static void RunScriptingSuite(const Config& config, Report& report)
+    {
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            RunCrowd(config, report, entityCount, s_SerialScriptPath, "OnRuntimeStartSerial", "OnUpdateRuntimeSerial");
+            RunCrowd(config, report, entityCount, s_ParallelScriptPath, "OnRuntimeStartParallel", "OnUpdateRuntimeParallel");
+            RunCrowd(config, report, entityCount, s_BatchedScriptPath, "OnRuntimeStartBatched", "OnUpdateRuntimeBatched");
+            RunCrowd(config, report, entityCount, s_TypedScriptPath, "OnRuntimeStartTyped", "OnUpdateRuntimeTyped");
+            RunCallOverhead(config, report, entityCount);
+            
+            RunGarbageCollector(config, report, entityCount, ScriptingEngine::GCMode::Automatic, "OnUpdateRuntimeGCAutomatic", nullptr);
+            RunGarbageCollector(config, report, entityCount, ScriptingEngine::GCMode::Incremental, "OnUpdateRuntimeGCIncremental", "LuaGCIncremental");
+            RunGarbageCollector(config, report, entityCount, ScriptingEngine::GCMode::Generational, "OnUpdateRuntimeGCGenerational", "LuaGCGenerational");
+        }
+    }
+
+    static SuiteRegistrar s_ScriptingSuite("Scripting", &RunScriptingSuite);
+}
@@ -0,0 +1,170 @@
+//
+//  SpatialIndexBenchmark.cpp
+//  Benchmark
+//
+//  Created by Nicolas U on 17.10.26.
+//
+//  Micro benchmark of the scene spatial index (SpatialIndex), without a scene around it: entities are small boxes spread
+//  over a flat open world. Every frame moves 10% of them a little (most stay in their cell) and runs a batch of
+//  box, sphere, frustum and ray queries of gameplay size. Meant to be run with large counts, e.g. `--entities 1000000`.
+//
+
+#include "Benchmark.hpp"
+
+#include "Spectral.h"
+#include "Math/SpatialIndex.hpp"
+
+#include "raymath.h"
+
+#include <random>
+
+namespace Spectral::Bench {
+
+    static constexpr float s_EntitySpacing = 2.0f;   // average distance between two entities
+    static constexpr uint32_t s_QueriesPerFrame = 256; // per query type, the frustum runs once per frame
+
+    static BoundingBox MakeBox(const Vector3& center, float halfSize)
+    {
+        return (BoundingBox){ {center.x - halfSize, center.y - halfSize, center.z - halfSize}, {center.x + halfSize, center.y + halfSize, center.z + halfSize} };
+    }
+
+    static void RunSpatialIndexSuite(const Config& config, Report& report)
+    {
+        for (uint32_t entityCount : config.EntityCounts)
+        {
+            std::vector<double> insertSamples;
+            std::vector<double> updateSamples;
+            std::vector<double> boxSamples;
+            std::vector<double> sphereSamples;
+            std::vector<double> frustumSamples;
+            std::vector<double> raySamples;
+
+            const size_t frameSamples = (size_t)config.Frames * config.Runs;
+            updateSamples.reserve(frameSamples);
+            boxSamples.reserve(frameSamples);
+            sphereSamples.reserve(frameSamples);
+            frustumSamples.reserve(frameSamples);
+            raySamples.reserve(frameSamples);
+
+            const float worldSize = std::ceil(std::sqrt((float)entityCount)) * s_EntitySpacing;
+
+            for (uint32_t run = 0; run < config.Runs; run++)
+            {
+                std::mt19937 rng(run + 1);
+                std::uniform_real_distribution<float> position(0.0f, worldSize);
+                std::uniform_real_distribution<float> height(0.0f, 8.0f);
+                std::uniform_real_distribution<float> size(0.25f, 1.0f);
+                std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+                std::uniform_int_distribution<uint32_t> pick(0, entityCount - 1);
+
+                // plain handles, the index only uses them as keys
+                std::vector<entt::entity> entities(entityCount);
+                std::vector<Vector3> centers(entityCount);
+                std::vector<float> halfSizes(entityCount);
+
+                for (uint32_t i = 0; i < entityCount; i++)
+                {
+                    entities[i] = (entt::entity)i;
+                    centers[i] = {position(rng), height(rng), position(rng)};
+                    halfSizes[i] = size(rng);
+                }
+
+                SpatialIndex index;
+
+                Timer timer;
+                index.Reserve(entityCount);
+                for (uint32_t i = 0; i < entityCount; i++) {
+                    index.Insert(entities[i], MakeBox(centers[i], halfSizes[i]));
+                }
+                insertSamples.push_back(timer.ElapsedMs());
+
+                const uint32_t movedCount = std::max<uint32_t>(entityCount / 10, 1);
+                size_t found = 0; // keeps the queries from being optimized away
+
+                for (uint32_t frame = 0; frame < config.WarmupFrames + config.Frames; frame++)
+                {
+                    // update
+                    std::vector<uint32_t> moved(movedCount);
+                    for (uint32_t& i : moved)
+                    {
+                        i = pick(rng);
+                        centers[i].x += offset(rng);
+                        centers[i].z += offset(rng);
+                    }
+
+                    timer.Reset();
+                    for (uint32_t i : moved) {
+                        index.Update(entities[i], MakeBox(centers[i], halfSizes[i]));
+                    }
+                    const double updateMs = timer.ElapsedMs();
+
+                    // box: 16x16 area around a random point (e.g. an AI looking for cover)
+                    std::vector<Vector3> points(s_QueriesPerFrame);
+                    for (Vector3& point : points) {
+                        point = {position(rng), 4.0f, position(rng)};
+                    }
+
+                    timer.Reset();
+                    for (const Vector3& point : points) {
+                        index.QueryBox(MakeBox(point, 8.0f), [&](entt::entity, const BoundingBox&) { found++; });
+                    }
+                    const double boxMs = timer.ElapsedMs();
+
+                    // sphere: radius 10 around the same points (e.g. an explosion)
+                    timer.Reset();
+                    for (const Vector3& point : points) {
+                        index.QuerySphere(point, 10.0f, [&](entt::entity, const BoundingBox&) { found++; });
+                    }
+                    const double sphereMs = timer.ElapsedMs();
+
+                    // ray: 50 units long, horizontal (e.g. a bullet)
+                    timer.Reset();
+                    for (const Vector3& point : points)
+                    {
+                        const float angle = (float)(found % 360) * DEG2RAD;
+                        const Ray ray = {point, {cosf(angle), 0.0f, sinf(angle)}};
+
+                        float closest = FLT_MAX;
+                        index.QueryRay(ray, 50.0f, [&](entt::entity, float distance) { closest = std::min(closest, distance); });
+                        found += closest < FLT_MAX ? 1 : 0;
+                    }
+                    const double rayMs = timer.ElapsedMs();
+
+                    // frustum: a game camera above a random point, looking down the z axis
+                    const Vector3 eye = {points[0].x, 20.0f, points[0].z};
+                    const Matrix view = MatrixLookAt(eye, (Vector3){eye.x, 0.0f, eye.z + 50.0f}, (Vector3){0.0f, 1.0f, 0.0f});
+                    const Matrix projection = MatrixPerspective(60.0 * DEG2RAD, 16.0 / 9.0, 0.1, 200.0);
+
+                    Math::Frustum frustum;
+                    Math::ExtractFrustrum(projection, view, &frustum);
+
+                    timer.Reset();
+                    index.QueryFrustum(frustum, [&](entt::entity, const BoundingBox&) { found++; });
+                    const double frustumMs = timer.ElapsedMs();
+
+                    if (frame >= config.WarmupFrames)
+                    {
+                        updateSamples.push_back(updateMs);
+                        boxSamples.push_back(boxMs);
+                        sphereSamples.push_back(sphereMs);
+                        raySamples.push_back(rayMs);
+                        frustumSamples.push_back(frustumMs);
+                    }
+                }
+
+                if (found == 0) {
+                    SP_LOG_WARN("SpatialIndex benchmark: no query found anything");
+                }
+            }
+
+            report.AddSamples("SpatialIndex", "Insert", entityCount, std::move(insertSamples));
+            report.AddSamples("SpatialIndex", "Update10Percent", entityCount, std::move(updateSamples));
+            report.AddSamples("SpatialIndex", "QueryBox", entityCount, std::move(boxSamples));
+            report.AddSamples("SpatialIndex", "QuerySphere", entityCount, std::move(sphereSamples));
+            report.AddSamples("SpatialIndex", "QueryRay", entityCount, std::move(raySamples));
+            report.AddSamples("SpatialIndex", "QueryFrustum", entityCount, std::move(frustumSamples));
+        }
+    }
+
+    static SuiteRegistrar s_SpatialIndexSuite("SpatialIndex", &RunSpatialIndexSuite);
+}
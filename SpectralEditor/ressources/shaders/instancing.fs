@@ -0,0 +1,19 @@
+#version 100
+
+precision mediump float;
+
+// Input vertex attributes (from vertex shader)
+varying vec3 fragPosition;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+varying vec3 fragNormal;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+void main()
+{
+    // @NOTE: unlit on purpose, matches the default raylib shader used by the non instanced path
+    gl_FragColor = texture2D(texture0, fragTexCoord)*colDiffuse*fragColor;
+}
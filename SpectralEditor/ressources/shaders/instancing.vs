@@ -0,0 +1,31 @@
+#version 100
+
+// Input vertex attributes
+attribute vec3 vertexPosition;
+attribute vec2 vertexTexCoord;
+attribute vec3 vertexNormal;
+attribute vec4 vertexColor;
+
+// Per instance model matrix, filled by DrawMeshInstanced
+attribute mat4 instanceTransform;
+
+// Input uniform values (mvp only contains view * projection when drawing instanced)
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+varying vec3 fragPosition;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+varying vec3 fragNormal;
+
+void main()
+{
+    // Send vertex attributes to fragment shader
+    fragPosition = vec3(instanceTransform*vec4(vertexPosition, 1.0));
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    fragNormal = normalize(vec3(instanceTransform*vec4(vertexNormal, 0.0)));
+
+    // Calculate final vertex position
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}
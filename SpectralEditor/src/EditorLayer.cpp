@@ -12,6 +12,7 @@
 #include "Core/SceneSerializer.hpp"
 #include "Panels/StatisticsPanel.hpp"
 #include "Renderer/Shaders.hpp"
+#include "Math/Math.hpp"
 
 #include "rlImGui.h"
 #include "imgui.h"
@@ -69,6 +70,14 @@ namespace Spectral {
         
         if (m_CurrentState == SceneState::Play)
         {
+            // hot reload of the edited scripts, the files are checked once per second (cmd + R forces it)
+            m_ScriptReloadTimer += ts;
+            if (m_ScriptReloadTimer >= 1.0f || (command && IsKeyPressed(KEY_R)))
+            {
+                m_ActiveScene->ReloadChangedScripts();
+                m_ScriptReloadTimer = 0.0f;
+            }
+            
             m_ActiveScene->OnUpdateRuntime(ts);
         } else {
             m_ActiveScene->OnUpdateEditor(ts);
@@ -307,9 +316,9 @@ namespace Spectral {
             Matrix cameraProjection = m_EditorCamera.GetCameraProjectionMatrix(windowWidth/windowHeight);
             Matrix cameraView = m_EditorCamera.GetCameraViewMatrix();
             
-            // recompose matrix
-            float transformMatrix[4 * 4];
-            ImGuizmo::RecomposeMatrixFromComponents(Vector3ToFloat(tc.Translation), Vector3ToFloat(tc.Rotation), Vector3ToFloat(tc.Scale), transformMatrix);
+            // the gizmo edits the world matrix directly, the rotation never goes through euler angles
+            const auto& world = selectedEntity.GetComponent<WorldTransformComponent>();
+            float16 transformMatrix = MatrixToFloatV(world.Transform);
         
             // snapping
             bool snap = IsKeyDown(KEY_LEFT_CONTROL);
@@ -319,19 +328,21 @@ namespace Spectral {
             }
             float snapValues[3] = { snapValue, snapValue, snapValue };
             
-            ImGuizmo::Manipulate(MatrixToFloat(cameraView), MatrixToFloat(cameraProjection), (ImGuizmo::OPERATION)m_CurrentGizmo, ImGuizmo::LOCAL, transformMatrix, nullptr, snap ? snapValues : nullptr);
+            ImGuizmo::Manipulate(MatrixToFloat(cameraView), MatrixToFloat(cameraProjection), (ImGuizmo::OPERATION)m_CurrentGizmo, ImGuizmo::LOCAL, transformMatrix.v, nullptr, snap ? snapValues : nullptr);
             
             if (ImGuizmo::IsUsing())
             {
-                float translation[3];
-                float rotation[3];
-                float scale[3];
+                // back to the space of the parent, the transform component is relative to it
+                const float* m = transformMatrix.v;
+                Matrix transform = { m[0], m[4], m[8], m[12], m[1], m[5], m[9], m[13], m[2], m[6], m[10], m[14], m[3], m[7], m[11], m[15] };
                 
-                ImGuizmo::DecomposeMatrixToComponents(transformMatrix, translation, rotation, scale);
+                if (world.Parent != entt::null)
+                {
+                    Entity parent = { world.Parent, m_ActiveScene.get() };
+                    transform = MatrixMultiply(transform, MatrixInvert(parent.GetComponent<WorldTransformComponent>().Transform));
+                }
                 
-                tc.Translation = {translation[0], translation[1], translation[2]};
-                tc.Rotation = {rotation[0], rotation[1], rotation[2]};
-                tc.Scale = {scale[0], scale[1], scale[2]};
+                Math::DecomposeTransform(transform, &tc.Translation, &tc.Rotation, &tc.Scale);
             }
         }
     }
@@ -339,54 +350,15 @@ namespace Spectral {
     void EditorLayer::MousePicking()
 {
         // @TODO: Fix mouse position
-        // @TODO: Fix sprite bounds colllision
         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && m_ViewportFocused && !ImGuizmo::IsOver() && !ImGuizmo::IsUsing())
         {
             Vector2 relativeMousePosition = (Vector2){(float)GetMousePosition().x - (float)m_ViewportRect.x, (float)GetMousePosition().y - (float)m_ViewportRect.y};
             
             Ray mouseRay = GetScreenToWorldRayEx(relativeMousePosition, m_EditorCamera.GetCamera3D(), m_ViewportRect.width, m_ViewportRect.height);
 
+            // closest sprite/model under the mouse, see Scene::PickEntity
             RayCollision collision = { 0 };
-            collision.hit = false;
-            collision.distance = FLT_MAX;
-            
-            // handle sprite
-            {
-                auto view = m_ActiveScene->m_Registry.view<SpriteComponent>();
-                for (auto entity : view)
-                {
-                    Entity entt = { entity, m_ActiveScene.get() };
-           
-                    auto& sprite = entt.GetComponent<SpriteComponent>();
-                        
-                    //RayCollision spriteCollision = GetRayCollisionQuad(mouseRay, sprite.Bounds[0], sprite.Bounds[1], sprite.Bounds[2], sprite.Bounds[3]);
-                        
-                    /*if (spriteCollision.hit && spriteCollision.distance < collision.distance) {
-                        collision = spriteCollision;
-                        m_SelectedEntity = entt;
-                    }*/
-                }
-            }
-            
-            
-            // handle model
-            /*{
-                auto view = m_ActiveScene->m_Registry.view<ModelComponent>();
-                for (auto entity : view)
-                {
-                    Entity entt = { entity, m_ActiveScene.get() };
-           
-                    auto& model = entt.GetComponent<ModelComponent>();
-                        
-                    RayCollision modelCollision; //= GetRayCollisionMesh(mouseRay, Mesh mesh, Matrix transform);
-                        
-                    if (modelCollision.hit && modelCollision.distance < collision.distance) {
-                        collision = modelCollision;
-                        m_SelectedEntity = entt;
-                    }
-                }
-            }*/
-            
+            m_SelectedEntity = m_ActiveScene->PickEntity(mouseRay, collision);
             
             // Update the collision info with the closest hit
             if (collision.hit) {
@@ -414,6 +386,7 @@ namespace Spectral {
         }
         
         m_CurrentState = SceneState::Play;
+        m_ScriptReloadTimer = 0.0f;
         
         // m_ActiveScene = new Scene();
         m_ActiveScene->OnRuntimeStart();
@@ -40,6 +40,7 @@ namespace Spectral {
         Rectangle m_ViewportRect;
     
         SceneState m_CurrentState = SceneState::Edit;
+        float m_ScriptReloadTimer = 0.0f; // seconds since the script files were last checked for changes (play mode)
         int m_CurrentGizmo = -1;
     
         Entity m_SelectedEntity; // entity selected by mouse picking
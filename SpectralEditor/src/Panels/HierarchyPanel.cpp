@@ -29,10 +29,13 @@ namespace Spectral {
         
         if (m_Context)
         {
+            // children are drawn by their parent node
             for (auto entityID : m_Context->m_Registry.view<entt::entity>())
             {
                 Entity entity{ entityID, m_Context.get() };
-                DrawEntityNode(entity);
+                if (!entity.GetParent()) {
+                    DrawEntityNode(entity);
+                }
             }
             
             if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered())
@@ -87,8 +90,15 @@ namespace Spectral {
 
     void HierarchyPanel::DrawEntityNode(Entity entity)
     {
+        const auto* relationship = m_Context->m_Registry.try_get<RelationshipComponent>(entity);
+        const bool hasChildren = relationship && relationship->ChildrenCount > 0;
+        
         ImGuiTreeNodeFlags flags = ((m_SelectedEntity == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
         flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (!hasChildren) {
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        }
+        
         const char* name = entity.GetComponent<IDComponent>().Name.c_str();
         bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, name);
         
@@ -97,39 +107,82 @@ namespace Spectral {
             m_SelectedEntity = entity;
         }
         
+        // drag an entity onto another one to make it a child
+        if (ImGui::BeginDragDropSource())
+        {
+            entt::entity handle = entity;
+            ImGui::SetDragDropPayload("ENTITY_PAYLOAD", &handle, sizeof(entt::entity));
+            ImGui::Text("%s", name);
+            ImGui::EndDragDropSource();
+        }
+        
+        bool reparented = false;
+        if (ImGui::BeginDragDropTarget())
+        {
+            if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ENTITY_PAYLOAD"))
+            {
+                Entity child{ *(const entt::entity*)payload->Data, m_Context.get() };
+                child.SetParent(entity);
+                reparented = true;
+            }
+            ImGui::EndDragDropTarget();
+        }
+        
         bool removeNode = false;
         if (ImGui::BeginPopupContextItem(0))
         {
             if (ImGui::MenuItem("Delete ", name)) {
                 removeNode = true;
             }
+            
+            if (entity.GetParent() && ImGui::MenuItem("Detach from parent")) {
+                entity.SetParent({});
+                reparented = true;
+            }
             ImGui::EndPopup();
         }
         
         if (opened)
         {
-            ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
-            bool opened = ImGui::TreeNodeEx((void*)9817239, flags, name); // (void*)9817239 some random id just for testing
-            if (opened)
+            // the children list was modified while drawing, draw it next frame
+            if (hasChildren && !reparented && !removeNode)
             {
-                ImGui::TreePop();
+                entt::entity child = relationship->FirstChild;
+                while (child != entt::null)
+                {
+                    entt::entity next = m_Context->m_Registry.get<RelationshipComponent>(child).NextSibling;
+                    DrawEntityNode({ child, m_Context.get() });
+                    child = next;
+                }
             }
-                        
+            
             ImGui::TreePop();
         }
         
         if (removeNode)
         {
-            m_Context->RemoveEntity(entity);
-            
-            if (m_SelectedEntity == entity) {
+            // children are removed together with their parent
+            if (m_SelectedEntity && (m_SelectedEntity == entity || IsDescendantOf(m_SelectedEntity, entity))) {
                 m_SelectedEntity = {};
             }
+            
+            m_Context->RemoveEntity(entity);
             removeNode = false;
         }
         
     }
 
+    bool HierarchyPanel::IsDescendantOf(Entity entity, Entity ancestor)
+    {
+        for (Entity parent = entity.GetParent(); parent; parent = parent.GetParent())
+        {
+            if (parent == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     void HierarchyPanel::DrawProperties() 
     {
         // setup component general
@@ -160,16 +213,16 @@ namespace Spectral {
             
             ImGui::PopStyleColor();
             
-            const char* layerMaskStrings[] = { "Static", "Default", "Custom1", "Custom2"};
-            const char* currentLayerMaskString = layerMaskStrings[(uint16_t)idc.LayerMask];
+            // layers come from the collision matrix of the scene
+            const CollisionMatrix3D& collisionMatrix = m_Context->GetPhysicsSettings().Collision3D;
+            const char* currentLayerMaskString = idc.LayerMask < collisionMatrix.GetLayerCount() ? collisionMatrix.Layers[idc.LayerMask].Name.c_str() : "Invalid";
             if (ImGui::BeginCombo("LayerMask", currentLayerMaskString))
             {
-                for (int i = 0; i < 4; i++)
+                for (uint32_t i = 0; i < collisionMatrix.GetLayerCount(); i++)
                 {
-                    bool isSelected = currentLayerMaskString == layerMaskStrings[i];
-                    if (ImGui::Selectable(layerMaskStrings[i], isSelected))
+                    bool isSelected = idc.LayerMask == i;
+                    if (ImGui::Selectable(collisionMatrix.Layers[i].Name.c_str(), isSelected))
                     {
-                        currentLayerMaskString = layerMaskStrings[i];
                         idc.LayerMask = (uint16_t)i;
                     }
                     
@@ -228,9 +281,14 @@ namespace Spectral {
         
         DrawComponent<TransformComponent>("Transform", /*calling anonymous function*/ [](auto& component) {
             DrawVector3Control("Translation", component.Translation);
-            Vector3 rotation = Vector3Scale(component.Rotation, RAD2DEG); // use rotation in degree instead of radians
+            const Vector3 euler = Vector3Scale(component.GetEulerAngles(), RAD2DEG); // use rotation in degree instead of radians
+            Vector3 rotation = euler;
             DrawVector3Control("Rotation", rotation);
-            component.Rotation = Vector3Scale(rotation, DEG2RAD); // convert back to radians
+            
+            // only convert back when edited, the quaternion would drift from the euler round trip every frame
+            if (!Vector3Equals(rotation, euler)) {
+                component.SetEulerAngles(Vector3Scale(rotation, DEG2RAD)); // convert back to radians
+            }
             DrawVector3Control("Scale", component.Scale);
         }, false);
         
@@ -27,6 +27,7 @@ namespace Spectral {
         
     private:
         void DrawEntityNode(Entity entity);
+        bool IsDescendantOf(Entity entity, Entity ancestor);
         void DrawProperties();
         
         template <typename T, typename F>
@@ -40,9 +41,3 @@ namespace Spectral {
     };
 }
 
-// @TODO: Implement groups
-// unused
-struct NodeGroup
-{
-    std::vector<Spectral::Entity> m_GroupEntity;
-};
@@ -12,6 +12,8 @@
 
 #include "materialdesign-main/IconsMaterialDesign.h"
 
+#include "Scripting/ScriptingEngine.hpp"
+
 #include "imgui.h"
 #include "raylib.h"
 #include "OpenGL/gl.h"
@@ -33,6 +35,18 @@ namespace Spectral {
                 ImGui::Text("Loaded Assets: %zu", AssetsManager::GetLoadedAssetsCount());
                 ImGui::Text("Loaded Entities: %zu", m_Context->GetEntityCount());
                 
+                const Scene::RenderStats& renderStats = m_Context->GetRenderStats();
+                ImGui::Text("Visible Entities: %zu / %zu", renderStats.VisibleEntities, renderStats.RenderableEntities);
+                ImGui::Text("Render Batches: %zu", renderStats.RenderBatches);
+                ImGui::Text("Draw Calls: %zu", renderStats.DrawCalls);
+                
+                const Scene::PhysicsStats& physicsStats = m_Context->GetPhysicsStats();
+                ImGui::Text("Physics Bodies: %zu (3D) %zu (2D)", physicsStats.Bodies3D, physicsStats.Bodies2D);
+                ImGui::Text("Shape Cache: %zu shapes, %.1f%% hits", physicsStats.CachedShapes, physicsStats.GetShapeCacheHitRate() * 100.0f);
+                
+                const ScriptingEngine::GCStats& gcStats = ScriptingEngine::GetGCStats();
+                ImGui::Text("Lua Heap: %.1f KB, GC: %.2f ms (%u steps)", gcStats.HeapBytes / 1024.0f, gcStats.TimeMs, gcStats.Steps);
+                
                 ImGui::Separator();
                 
                 // @TODO: Add: "Build: VERSION (__TIME__) (__DATE__) Debug/Release"
@@ -13,6 +13,8 @@
 #include "ImGuizmo.h"
 #include "raylib.h"
 
+#include "Core/JobSystem.hpp"
+#include "Physics/PhysicsEngine3D.hpp"
 #include "Renderer/Shaders.hpp"
 #include "Scripting/ScriptingEngine.hpp"
 
@@ -28,6 +30,8 @@ namespace Spectral {
         
         // m_ImGuiLayer = new ImGuiLayer();
         // PushOverlay(m_ImGuiLayer);
+        JobSystem::Init();
+        PhysicsEngine3D::Init();
         ScriptingEngine::Init();
         Shaders::LoadShaders();
     }
@@ -35,7 +39,13 @@ namespace Spectral {
     Application::~Application()
     {
         SP_LOG_INFO("Engine::Shutdown");
+        
+        // the layers own the scenes and so their physics worlds, they have to go before the engine systems they use
+        m_LayerStack.Clear();
+        
         Shaders::UnloadShaders();
+        PhysicsEngine3D::Shutdown(); // before the JobSystem, the Jolt jobs run on its workers
+        JobSystem::Shutdown();
     }
 
     void Application::Run()
@@ -0,0 +1,75 @@
+//
+//  FrameArena.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "FrameArena.hpp"
+
+#include <algorithm>
+
+namespace Spectral {
+
+    FrameArena::FrameArena(size_t blockSize)
+        : m_BlockSize(blockSize)
+    {
+    }
+
+    void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        while (m_CurrentBlock < m_Blocks.size())
+        {
+            Block& block = m_Blocks[m_CurrentBlock];
+
+            const uintptr_t base = (uintptr_t)block.Data.get();
+            const uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            const size_t offset = (size_t)(aligned - base);
+
+            if (offset + size <= block.Size)
+            {
+                m_Offset = offset + size;
+                return block.Data.get() + offset;
+            }
+
+            // current block is full, continue in the next one
+            m_CurrentBlock++;
+            m_Offset = 0;
+        }
+
+        // out of blocks, oversized allocations get a block of their own
+        Block block;
+        block.Size = std::max(m_BlockSize, size + alignment);
+        block.Data = std::make_unique<uint8_t[]>(block.Size);
+        m_Blocks.push_back(std::move(block));
+
+        m_CurrentBlock = m_Blocks.size() - 1;
+        m_Offset = 0;
+
+        return Allocate(size, alignment);
+    }
+
+    void FrameArena::Reset()
+    {
+        m_CurrentBlock = 0;
+        m_Offset = 0;
+    }
+
+    size_t FrameArena::GetUsedBytes() const
+    {
+        size_t used = m_Offset;
+        for (size_t i = 0; i < m_CurrentBlock && i < m_Blocks.size(); i++) {
+            used += m_Blocks[i].Size;
+        }
+        return used;
+    }
+
+    size_t FrameArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : m_Blocks) {
+            capacity += block.Size;
+        }
+        return capacity;
+    }
+}
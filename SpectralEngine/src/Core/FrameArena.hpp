@@ -0,0 +1,51 @@
+//
+//  FrameArena.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Spectral {
+
+    // Linear allocator for data that only lives for one frame.
+    // Allocations are a pointer bump, nothing is freed individually, Reset() makes the whole memory reusable.
+    // Memory is allocated in blocks that never move, so returned pointers stay valid until the next Reset().
+    class FrameArena
+    {
+    public:
+        FrameArena(size_t blockSize = 64 * 1024);
+
+        void* Allocate(size_t size, size_t alignment);
+
+        // @NOTE: destructors are never called, only use it for trivially destructible types
+        template<typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "FrameArena never calls destructors");
+            return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        void Reset(); // keeps the allocated blocks for the next frame
+
+        size_t GetUsedBytes() const;
+        size_t GetCapacity() const;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<uint8_t[]> Data;
+            size_t Size = 0;
+        };
+
+        std::vector<Block> m_Blocks;
+        size_t m_BlockSize;
+        size_t m_CurrentBlock = 0;
+        size_t m_Offset = 0;
+    };
+}
@@ -0,0 +1,269 @@
+//
+//  JobSystem.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Spectral {
+
+    struct Job
+    {
+        JobSystem::JobFunction Function;
+        JobCounter* Counter = nullptr;
+    };
+
+    // @NOTE: the deques are guarded by a mutex each, contention is low since threads mostly work on their own deque
+    struct WorkQueue
+    {
+        std::mutex Mutex;
+        std::deque<Job> Jobs;
+    };
+
+    struct JobSystemData
+    {
+        std::vector<std::thread> Workers;
+        std::unique_ptr<WorkQueue[]> Queues; // [0] main thread, [1..N] workers
+        uint32_t QueueCount = 1;
+
+        // idle workers sleep until new jobs are pushed
+        std::mutex SleepMutex;
+        std::condition_variable SleepCondition;
+        std::atomic<uint32_t> PendingJobs = 0;
+
+        std::atomic<bool> Running = false;
+    };
+
+    static JobSystemData s_Data;
+    static thread_local uint32_t t_ThreadIndex = 0;
+
+    static void PushJob(uint32_t threadIndex, Job&& job)
+    {
+        {
+            WorkQueue& queue = s_Data.Queues[threadIndex];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.Jobs.push_back(std::move(job));
+        }
+
+        s_Data.PendingJobs.fetch_add(1, std::memory_order_release);
+
+        // take the sleep lock, so a worker can not miss the notification between checking and waiting
+        {
+            std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+        }
+        s_Data.SleepCondition.notify_one();
+    }
+
+    static bool PopJob(uint32_t threadIndex, Job& job)
+    {
+        // own deque first, newest job (LIFO) has the warmest caches
+        {
+            WorkQueue& queue = s_Data.Queues[threadIndex];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+
+            if (!queue.Jobs.empty())
+            {
+                job = std::move(queue.Jobs.back());
+                queue.Jobs.pop_back();
+                return true;
+            }
+        }
+
+        // steal the oldest job (FIFO) from the other threads, usually the biggest piece of work
+        for (uint32_t i = 1; i < s_Data.QueueCount; i++)
+        {
+            WorkQueue& victim = s_Data.Queues[(threadIndex + i) % s_Data.QueueCount];
+            std::lock_guard<std::mutex> lock(victim.Mutex);
+
+            if (!victim.Jobs.empty())
+            {
+                job = std::move(victim.Jobs.front());
+                victim.Jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobSystem::TryRunJob(uint32_t threadIndex)
+    {
+        if (s_Data.PendingJobs.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        Job job;
+        if (!PopJob(threadIndex, job)) {
+            return false;
+        }
+
+        s_Data.PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+        job.Function();
+
+        if (job.Counter) {
+            job.Counter->m_Value.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(uint32_t threadIndex)
+    {
+        t_ThreadIndex = threadIndex;
+
+        while (true)
+        {
+            if (TryRunJob(threadIndex)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(s_Data.SleepMutex);
+            s_Data.SleepCondition.wait(lock, [] {
+                return !s_Data.Running.load() || s_Data.PendingJobs.load(std::memory_order_acquire) > 0;
+            });
+
+            if (!s_Data.Running.load() && s_Data.PendingJobs.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    void JobSystem::Init(uint32_t workerCount)
+    {
+        if (s_Data.Running) {
+            return;
+        }
+
+        if (workerCount == 0)
+        {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+
+        SP_LOG_INFO("JobSystem::Init with {0} worker threads", workerCount);
+
+        s_Data.QueueCount = workerCount + 1;
+        s_Data.Queues = std::make_unique<WorkQueue[]>(s_Data.QueueCount);
+        s_Data.PendingJobs = 0;
+        s_Data.Running = true;
+
+        s_Data.Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            s_Data.Workers.emplace_back(&JobSystem::WorkerLoop, i + 1);
+        }
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!s_Data.Running) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+            s_Data.Running = false;
+        }
+        s_Data.SleepCondition.notify_all();
+
+        // workers drain the remaining jobs before they exit
+        for (std::thread& worker : s_Data.Workers) {
+            worker.join();
+        }
+
+        s_Data.Workers.clear();
+        s_Data.Queues.reset();
+        s_Data.QueueCount = 1;
+    }
+
+    void JobSystem::Run(JobFunction job, JobCounter* counter)
+    {
+        if (s_Data.Workers.empty())
+        {
+            job();
+            return;
+        }
+
+        if (counter) {
+            counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // threads that are not workers all share the deque of the main thread
+        PushJob(t_ThreadIndex, { std::move(job), counter });
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        // help out instead of blocking, this also keeps nested waits from dead locking
+        while (!counter.IsDone())
+        {
+            if (!TryRunJob(t_ThreadIndex)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& job)
+    {
+        if (s_Data.Workers.empty() || count == 1)
+        {
+            for (uint32_t i = 0; i < count; i++) {
+                job(i);
+            }
+            return;
+        }
+
+        JobCounter counter;
+
+        // the calling thread takes the first index itself, the rest can be stolen
+        for (uint32_t i = 1; i < count; i++) {
+            Run([&job, i]() { job(i); }, &counter);
+        }
+
+        if (count > 0) {
+            job(0);
+        }
+
+        Wait(counter);
+    }
+
+    void JobSystem::ParallelForRange(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& job)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        // a few ranges per thread, so uneven ranges still balance out through stealing
+        const size_t maxRanges = (size_t)GetThreadCount() * 4;
+        const size_t rangeCount = std::min(maxRanges, (count + grainSize - 1) / grainSize);
+        const size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+
+        ParallelFor((uint32_t)rangeCount, [&](uint32_t index) {
+            const size_t begin = index * rangeSize;
+            const size_t end = std::min(begin + rangeSize, count);
+
+            if (begin < end) {
+                job(begin, end);
+            }
+        });
+    }
+
+    uint32_t JobSystem::GetThreadCount()
+    {
+        return (uint32_t)s_Data.Workers.size() + 1;
+    }
+
+    uint32_t JobSystem::GetThreadIndex()
+    {
+        return t_ThreadIndex;
+    }
+}
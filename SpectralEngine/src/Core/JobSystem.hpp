@@ -0,0 +1,78 @@
+//
+//  JobSystem.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include <atomic>
+#include <functional>
+
+#include "entt.hpp"
+
+namespace Spectral {
+
+    // Dependency counter: number of unfinished jobs that were started with it.
+    // JobSystem::Wait() returns once it drops to zero, a counter can be reused after that.
+    class JobCounter
+    {
+    public:
+        bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+        uint32_t GetValue() const { return m_Value.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<uint32_t> m_Value = 0;
+
+        friend class JobSystem;
+    };
+
+    // Engine wide work stealing scheduler, shared by the scene update, rendering and physics (see JoltJobSystem).
+    // Every thread owns a deque: new jobs are pushed to the deque of the calling thread and popped from its back (LIFO),
+    // idle threads steal from the front of the other deques (FIFO).
+    // Without Init() (or with 0 workers) every job runs on the calling thread.
+    class JobSystem
+    {
+    public:
+        using JobFunction = std::function<void()>;
+
+        static void Init(uint32_t workerCount = 0); // 0 = one worker per hardware thread, minus the main thread
+        static void Shutdown();
+
+        // fork: schedules the job, the counter is incremented right away and decremented once the job has finished
+        static void Run(JobFunction job, JobCounter* counter = nullptr);
+
+        // join: works on pending jobs until the counter reaches zero, so it can also be called from inside of a job
+        static void Wait(const JobCounter& counter);
+
+        // runs job(index) for every index in [0, count) and returns once all of them are done
+        static void ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& job);
+
+        // splits [0, count) into ranges of at least grainSize elements, a few ranges per thread
+        static void ParallelForRange(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& job);
+
+        // calls func(entity) for every entity of an entt view (or storage), the entities are split into ranges of at least grainSize
+        // @NOTE: func must not add/remove entities or components, the registry is not thread safe
+        template<typename View, typename Func>
+        static void ParallelForEach(const View& view, size_t grainSize, Func func)
+        {
+            // entt views only have forward iterators, take a snapshot of the entities first
+            const std::vector<entt::entity> entities(view.begin(), view.end());
+
+            ParallelForRange(entities.size(), grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    func(entities[i]);
+                }
+            });
+        }
+
+        static uint32_t GetThreadCount(); // workers + the calling thread
+        static uint32_t GetThreadIndex(); // 0 for the main thread (and any thread that is not a worker), 1..N for workers
+
+    private:
+        static bool TryRunJob(uint32_t threadIndex);
+        static void WorkerLoop(uint32_t threadIndex);
+    };
+}
@@ -15,12 +15,20 @@ namespace Spectral {
     }
 
     LayerStack::~LayerStack() 
+    {
+        Clear();
+    }
+
+    void LayerStack::Clear()
     {
         for (Layer* layer : m_Layers)
         {
             layer->OnDetach();
             delete layer; // removes all pointers
         }
+        
+        m_Layers.clear();
+        m_LayerInsert = m_Layers.begin();
     }
 
     void LayerStack::PushLayer(Layer* layer)
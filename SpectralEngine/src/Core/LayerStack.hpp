@@ -23,6 +23,9 @@ namespace Spectral {
         void PopLayer(Layer* layer);
         void PopOverlay(Layer* overlay);
         
+        // detaches and deletes every layer (and so the scenes they own)
+        void Clear();
+        
         std::vector<Layer*>::iterator begin() { return m_Layers.begin(); }
         std::vector<Layer*>::iterator end() { return m_Layers.end(); }
         
@@ -8,24 +8,31 @@
 #include "Scene.hpp"
 
 #include "Entt/Entity.hpp"
+#include "Core/JobSystem.hpp"
 #include "Renderer/Renderer.hpp"
 #include "Scripting/ScriptingEngine.hpp"
-#include "Physics/PhysicsEngine3D.hpp"
+#include "Physics/PhysicsWorld3D.hpp"
+#include "Physics/ShapeCache3D.hpp"
+#include "Physics/CollisionFilters3D.hpp"
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 
 #include "box2d/box2d.h"
 
+#include <cstring>
+#include <map>
+#include <atomic>
+
 // Jolt includes
 #include <Jolt/Jolt.h>
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
-#include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
@@ -33,6 +40,24 @@
 
 namespace Spectral {
 
+    Scene::Scene(const std::string& name)
+        : m_Name(name), m_PhysicsQuery(this)
+    {
+        // every transform gets a cached world matrix, see UpdateWorldTransforms()
+        m_Registry.on_construct<TransformComponent>().connect<&entt::registry::emplace_or_replace<WorldTransformComponent>>();
+        m_Registry.on_construct<WorldTransformComponent>().connect<&Scene::OnTransformConstruct>(*this);
+        m_Registry.on_destroy<WorldTransformComponent>().connect<&Scene::OnTransformDestroy>(*this);
+        m_Registry.on_destroy<BoundsComponent>().connect<&Scene::OnBoundsDestroy>(*this);
+        m_Registry.on_destroy<RigidBody3DComponent>().connect<&Scene::OnRigidBody3DDestroy>(*this);
+    }
+
+    Scene::~Scene()
+    {
+        // the physics worlds also destroy the bodies that are left when the scene is destroyed while running
+        delete m_PhysicsWorld;
+        delete m_PhysicsWorld3D;
+    }
+
     Entity Scene::CreateEntity(UUID uuid, const std::string& name)
     {
         Entity entity = { m_Registry.create(), this };
@@ -45,106 +70,220 @@ namespace Spectral {
 
     void Scene::RemoveEntity(Entity entity)
     {
+        if (auto* relationship = m_Registry.try_get<RelationshipComponent>(entity))
+        {
+            entt::entity child = relationship->FirstChild;
+            while (child != entt::null)
+            {
+                entt::entity next = m_Registry.get<RelationshipComponent>(child).NextSibling;
+                RemoveEntity({child, this});
+                child = next;
+            }
+            
+            DetachFromParent(entity);
+        }
+        
         m_EntityMap.erase(entity.GetComponent<IDComponent>().ID);
         m_Registry.destroy(entity);
     }
 
+    void Scene::SetParent(Entity child, Entity parent)
+    {
+        if (!child || child == parent) {
+            return;
+        }
+        
+        // a parent can't be one of the child's descendants
+        for (entt::entity handle = parent; handle != entt::null;)
+        {
+            if (handle == (entt::entity)child) {
+                SP_LOG_WARN("Scene::SetParent - can't parent an entity to one of its descendants");
+                return;
+            }
+            
+            const auto* relationship = m_Registry.try_get<RelationshipComponent>(handle);
+            handle = relationship ? relationship->Parent : entt::null;
+        }
+        
+        // emplace both first, emplacing into the pool can invalidate references
+        if (parent && !m_Registry.all_of<RelationshipComponent>(parent)) {
+            m_Registry.emplace<RelationshipComponent>(parent);
+        }
+        if (!m_Registry.all_of<RelationshipComponent>(child)) {
+            m_Registry.emplace<RelationshipComponent>(child);
+        }
+        
+        if (m_Registry.get<RelationshipComponent>(child).Parent == (entt::entity)parent) {
+            return;
+        }
+        
+        DetachFromParent(child);
+        
+        if (parent)
+        {
+            auto& relationship = m_Registry.get<RelationshipComponent>(child);
+            auto& parentRelationship = m_Registry.get<RelationshipComponent>(parent);
+            
+            // append to the end of the children list to keep the creation order
+            if (parentRelationship.FirstChild == entt::null)
+            {
+                parentRelationship.FirstChild = child;
+            }
+            else
+            {
+                entt::entity last = parentRelationship.FirstChild;
+                while (m_Registry.get<RelationshipComponent>(last).NextSibling != entt::null) {
+                    last = m_Registry.get<RelationshipComponent>(last).NextSibling;
+                }
+                
+                m_Registry.get<RelationshipComponent>(last).NextSibling = child;
+                relationship.PrevSibling = last;
+            }
+            
+            relationship.Parent = parent;
+            parentRelationship.ChildrenCount++;
+        }
+        
+        // the cached parent version belongs to the old parent, force the subtree to be rebuilt
+        if (auto* world = m_Registry.try_get<WorldTransformComponent>(child)) {
+            world->Valid = false;
+        }
+        m_TransformOrderDirty = true;
+    }
+
+    void Scene::DetachFromParent(entt::entity child)
+    {
+        auto& relationship = m_Registry.get<RelationshipComponent>(child);
+        
+        if (relationship.Parent == entt::null) {
+            return;
+        }
+        
+        auto& parentRelationship = m_Registry.get<RelationshipComponent>(relationship.Parent);
+        
+        if (parentRelationship.FirstChild == child) {
+            parentRelationship.FirstChild = relationship.NextSibling;
+        }
+        if (relationship.PrevSibling != entt::null) {
+            m_Registry.get<RelationshipComponent>(relationship.PrevSibling).NextSibling = relationship.NextSibling;
+        }
+        if (relationship.NextSibling != entt::null) {
+            m_Registry.get<RelationshipComponent>(relationship.NextSibling).PrevSibling = relationship.PrevSibling;
+        }
+        
+        parentRelationship.ChildrenCount--;
+        
+        relationship.Parent = entt::null;
+        relationship.PrevSibling = entt::null;
+        relationship.NextSibling = entt::null;
+        
+        m_TransformOrderDirty = true;
+    }
+
+    // bodies are simulated in world space, the TransformComponent of a child is relative to its parent
+    static void GetWorldPose(const TransformComponent& transform, const WorldTransformComponent& world, Vector3* translation, Quaternion* rotation, Vector3* scale)
+    {
+        // roots keep their exact values, no round trip through the matrix
+        if (world.Parent == entt::null)
+        {
+            *translation = transform.Translation;
+            *rotation = transform.Rotation;
+            *scale = transform.Scale;
+            return;
+        }
+        
+        Math::DecomposeTransform(world.Transform, translation, rotation, scale);
+    }
+
+    // @NOTE: a child is converted with the world matrix of its parent from the last UpdateWorldTransforms(), a parent that
+    // moves in the same frame drags it along one frame late
+    static void SetWorldPose(entt::registry& registry, entt::entity handle, TransformComponent& transform, const Vector3& translation, const Quaternion& rotation)
+    {
+        const entt::entity parent = registry.get<WorldTransformComponent>(handle).Parent;
+        if (parent == entt::null)
+        {
+            transform.Translation = translation;
+            transform.Rotation = rotation;
+            return;
+        }
+        
+        const Matrix pose = MatrixMultiply(QuaternionToMatrix(rotation), MatrixTranslate(translation.x, translation.y, translation.z));
+        const Matrix local = MatrixMultiply(pose, MatrixInvert(registry.get<WorldTransformComponent>(parent).Transform));
+        
+        // the scale of the body never changes, only the one of the parent ends up in the matrix
+        Vector3 parentScale;
+        Math::DecomposeTransform(local, &transform.Translation, &transform.Rotation, &parentScale);
+    }
+
     void Scene::OnRuntimeStart()
     {
+        // the bodies are created at the world pose of their entity
+        UpdateWorldTransforms();
+        
         // physics
         {
             // 3D physics
             {
-                PhysicsEngine3D::Init();
-                
-                auto view = m_Registry.view<RigidBody3DComponent>();
-                for (auto handle : view)
+                // the world is kept between play sessions, only the bodies are recreated
+                if (m_PhysicsWorld3D && m_PhysicsWorld3D->GetCapacity() != m_PhysicsSettings.Capacity3D)
                 {
-                    Entity entt {handle, this};
-                    
-                    auto& rb3d = entt.GetComponent<RigidBody3DComponent>();
-                    auto& transform = entt.GetComponent<TransformComponent>();
-                    
-                    auto& bodyInterface = PhysicsEngine3D::GetPhysicsSystem().GetBodyInterface();
-                    
-                    JPH::MutableCompoundShapeSettings compoundShapeSettings;
-                    
-                    // setup shapes
-                    
-                    if (entt.HasComponent<BoxCollider3DComponent>())
-                    {
-                        auto& bc3d = entt.GetComponent<BoxCollider3DComponent>();
-                        
-                        // @NOTE: each physics model needs to be exported in 1,1,1 scale (need to add support for other scale sizes)
-                        JPH::BoxShapeSettings boxSettings({1.0f * transform.Scale.x, 1.0f * transform.Scale.y, 1.0f * transform.Scale.z});
-                        
-                        boxSettings.SetDensity(bc3d.Density);
-                        
-                        // @TODO: restitution
-                        
-                        compoundShapeSettings.AddShape({bc3d.Offset.x, bc3d.Offset.y, bc3d.Offset.z}, JPH::Quat::sIdentity(), boxSettings.Create().Get());
-                    }
-                    
-                    // @TODO: setup circle collider
-                    
-                    Quaternion rotation = QuaternionFromEuler(transform.Rotation.x, transform.Rotation.y, transform.Rotation.z);
-                    uint16_t layerIndex = entt.GetComponent<IDComponent>().LayerMask;
-                    
-                    // setup body
-                    JPH::BodyCreationSettings bodySettings(compoundShapeSettings.Create().Get(), {transform.Translation.x, transform.Translation.y, transform.Translation.z}, {rotation.x, rotation.y, rotation.z, rotation.w}, static_cast<JPH::EMotionType>(rb3d.Type), layerIndex);
-                    
-                    JPH::MassProperties massProperties;
-                    massProperties.mMass = rb3d.Mass;
-                    bodySettings.mMassPropertiesOverride = massProperties;
-                    bodySettings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
-                    
-                    bodySettings.mAllowSleeping = rb3d.AllowSleep;
-                    bodySettings.mLinearDamping = rb3d.LinearDrag;
-                    bodySettings.mAngularDamping = rb3d.AngularDrag;
-                    bodySettings.mGravityFactor = rb3d.GravityScale;
-                    
-                    // add body to world
-                    JPH::Body* body = bodyInterface.CreateBody(bodySettings);
-                    bodyInterface.AddBody(body->GetID(), rb3d.Awake ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
-                    
-                    rb3d.RuntimeBody = body;
+                    delete m_PhysicsWorld3D;
+                    m_PhysicsWorld3D = nullptr;
                 }
                 
-                JPH::PhysicsSystem& physicsSystem = PhysicsEngine3D::GetPhysicsSystem();
-                physicsSystem.OptimizeBroadPhase();
+                if (!m_PhysicsWorld3D) {
+                    m_PhysicsWorld3D = new PhysicsWorld3D(m_PhysicsSettings.Capacity3D);
+                }
+                
+                m_PhysicsWorld3D->SetCollisionMatrix(m_PhysicsSettings.Collision3D);
+                
+                CreateBodies3D();
             }
             
             // 2D physics
             {
                 m_PhysicsWorld = new b2World({0.0f, -10.0f} /*setting up the gravity*/);
                 
+                m_Bodies2D.clear();
+                m_MovingBodies2D.clear();
+                m_StoppedBodies2D.clear();
+                
                 auto view = m_Registry.view<RigidBody2DComponent>();
                 for (auto handle : view)
                 {
                     Entity entt = {handle, this};
                     
                     auto& rb2d = entt.GetComponent<RigidBody2DComponent>();
-                    auto& transform = entt.GetComponent<TransformComponent>();
+                    
+                    Vector3 translation, scale;
+                    Quaternion rotation;
+                    GetWorldPose(entt.GetComponent<TransformComponent>(), entt.GetComponent<WorldTransformComponent>(), &translation, &rotation, &scale);
+                    const Vector3 angles = QuaternionToEuler(rotation);
                     
                     b2BodyDef bodyDef;
                     bodyDef.type = (b2BodyType)rb2d.Type;
-                    bodyDef.position.Set(transform.Translation.x, transform.Translation.y);
-                    bodyDef.angle = transform.Rotation.z;
+                    bodyDef.position.Set(translation.x, translation.y);
+                    bodyDef.angle = angles.z;
                     
                     bodyDef.fixedRotation = rb2d.FixedRotation;
                     bodyDef.allowSleep = rb2d.AllowSleep;
                     bodyDef.awake = rb2d.Awake;
                     bodyDef.gravityScale = rb2d.GravityScale;
+                    bodyDef.userData.pointer = (uintptr_t)handle; // returned by the physics queries
                     
                     b2Body* body = m_PhysicsWorld->CreateBody(&bodyDef);
                     rb2d.RuntimeBody = body;
                     
+                    if (rb2d.Type != RigidBody2DComponent::BodyType::Static) {
+                        m_Bodies2D.push_back({body, handle});
+                    }
+                    
                     if (entt.HasComponent<BoxCollider2DComponent>())
                     {
                         auto& bc2d = entt.GetComponent<BoxCollider2DComponent>();
                         
                         b2PolygonShape boxShape;
-                        boxShape.SetAsBox((bc2d.Size.x / 2) * transform.Scale.x, (bc2d.Size.y / 2) * transform.Scale.y, b2Vec2(bc2d.Offset.x, bc2d.Offset.y), 0.0f);
+                        boxShape.SetAsBox((bc2d.Size.x / 2) * scale.x, (bc2d.Size.y / 2) * scale.y, b2Vec2(bc2d.Offset.x, bc2d.Offset.y), 0.0f);
                         
                         b2FixtureDef fixtureDef;
                         fixtureDef.shape = &boxShape;
@@ -156,12 +295,22 @@ namespace Spectral {
                     }
                     
                     // @TODO: Circle collider
+                    
+                    auto& state = m_Registry.emplace_or_replace<PhysicsInterpolationComponent>(handle);
+                    state.PreviousTranslation = state.CurrentTranslation = translation;
+                    state.PreviousRotation = state.CurrentRotation = QuaternionFromAxisAngle({0.0f, 0.0f, 1.0f}, bodyDef.angle);
+                    state.BaseRotation = QuaternionFromEuler(angles.x, angles.y, 0.0f);
                 }
             }
+            
+            m_PhysicsStats.Bodies2D = m_PhysicsWorld->GetBodyCount();
+            m_PhysicsAccumulator = 0.0f;
         }
         
         // lua scripts
         {
+            ScriptingEngine::SetPhysicsQuery(&m_PhysicsQuery);
+            
             auto view = m_Registry.view<LuaScriptComponent>();
             for (auto handle : view)
             {
@@ -169,33 +318,268 @@ namespace Spectral {
                 
                 ScriptingEngine::OnCreate(entt);
             }
+            
+            // garbage of loading the scripts, the first frames don't pay for it
+            ScriptingEngine::CollectGarbageFull();
+        }
+    }
+
+    void Scene::CreateBodies3D()
+    {
+        JPH::BodyInterface& bodyInterface = m_PhysicsWorld3D->GetPhysicsSystem().GetBodyInterface();
+        
+        auto view = m_Registry.view<RigidBody3DComponent>();
+        const std::vector<entt::entity> handles(view.begin(), view.end());
+        
+        std::vector<JPH::BodyID> bodyIDs(handles.size());
+        
+        // make sure every pool exists before the jobs run, try_get() would create a missing one
+        m_Registry.storage<BoxCollider3DComponent>();
+        m_Registry.storage<SphereCollider3DComponent>();
+        
+        ShapeCache3D& shapeCache = m_PhysicsWorld3D->GetShapeCache();
+        shapeCache.ResetStats();
+        
+        const CollisionMatrix3D& collisionMatrix = m_PhysicsSettings.Collision3D;
+        std::atomic<uint32_t> invalidLayers = 0;
+        std::atomic<uint32_t> invalidShapes = 0;
+        
+        // shapes and bodies are created in parallel, the registry is only read here (CreateBody is thread safe)
+        JobSystem::ParallelForRange(handles.size(), 128, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                const entt::entity handle = handles[i];
+                
+                auto& rb3d = m_Registry.get<RigidBody3DComponent>(handle);
+                
+                Vector3 translation, scale;
+                Quaternion rotation;
+                GetWorldPose(m_Registry.get<TransformComponent>(handle), m_Registry.get<WorldTransformComponent>(handle), &translation, &rotation, &scale);
+                
+                // setup shapes, identical colliders share the same shape
+                JPH::ShapeRefC shapes[2];
+                uint32_t shapeCount = 0;
+                uint32_t colliderCount = 0;
+                
+                if (const auto* bc3d = m_Registry.try_get<BoxCollider3DComponent>(handle))
+                {
+                    // @NOTE: each physics model needs to be exported in 1,1,1 scale (need to add support for other scale sizes)
+                    // @TODO: restitution
+                    colliderCount++;
+                    shapes[shapeCount] = shapeCache.GetBox(scale, bc3d->Offset, bc3d->Density);
+                    shapeCount += shapes[shapeCount] != nullptr;
+                }
+                
+                if (const auto* sc3d = m_Registry.try_get<SphereCollider3DComponent>(handle))
+                {
+                    const float maxScale = std::max(scale.x, std::max(scale.y, scale.z));
+                    colliderCount++;
+                    shapes[shapeCount] = shapeCache.GetSphere(sc3d->Radius * maxScale, sc3d->Offset, sc3d->Density);
+                    shapeCount += shapes[shapeCount] != nullptr;
+                }
+                
+                // colliders Jolt rejected are left out, the body still exists (without them)
+                if (shapeCount < colliderCount) {
+                    invalidShapes.fetch_add(colliderCount - shapeCount, std::memory_order_relaxed);
+                }
+                
+                // a compound shape only when the entity has several colliders
+                JPH::ShapeRefC shape;
+                if (shapeCount == 0)
+                {
+                    shape = shapeCache.GetEmpty();
+                }
+                else if (shapeCount == 1)
+                {
+                    shape = shapes[0];
+                }
+                else
+                {
+                    JPH::StaticCompoundShapeSettings compoundShapeSettings;
+                    for (uint32_t shapeIndex = 0; shapeIndex < shapeCount; shapeIndex++) {
+                        compoundShapeSettings.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), shapes[shapeIndex]);
+                    }
+                    shape = compoundShapeSettings.Create().Get();
+                }
+                
+                // layer of the collision matrix, the broadphase tree comes from the layer type or the motion type
+                uint32_t layerIndex = m_Registry.get<IDComponent>(handle).LayerMask;
+                if (layerIndex >= collisionMatrix.GetLayerCount())
+                {
+                    invalidLayers.fetch_add(1, std::memory_order_relaxed);
+                    layerIndex = std::min<uint32_t>(1, collisionMatrix.GetLayerCount() - 1); // Default
+                }
+                
+                BroadPhaseLayer3D broadPhaseLayer;
+                switch (collisionMatrix.Layers[layerIndex].Type)
+                {
+                    case CollisionMatrix3D::LayerType::Trigger: broadPhaseLayer = BroadPhaseLayer3D::Trigger; break;
+                    case CollisionMatrix3D::LayerType::Debris:  broadPhaseLayer = BroadPhaseLayer3D::Debris; break;
+                    default:
+                        broadPhaseLayer = rb3d.Type == RigidBody3DComponent::BodyType::Static    ? BroadPhaseLayer3D::Static
+                                        : rb3d.Type == RigidBody3DComponent::BodyType::Kinematic ? BroadPhaseLayer3D::Kinematic
+                                                                                                  : BroadPhaseLayer3D::Dynamic;
+                        break;
+                }
+                
+                // setup body
+                JPH::BodyCreationSettings bodySettings(shape, {translation.x, translation.y, translation.z}, {rotation.x, rotation.y, rotation.z, rotation.w}, static_cast<JPH::EMotionType>(rb3d.Type), CollisionTable3D::MakeObjectLayer(layerIndex, broadPhaseLayer));
+                bodySettings.mIsSensor = broadPhaseLayer == BroadPhaseLayer3D::Trigger;
+                bodySettings.mUserData = (uint64_t)handle; // returned by the physics queries
+                
+                JPH::MassProperties massProperties;
+                massProperties.mMass = rb3d.Mass;
+                bodySettings.mMassPropertiesOverride = massProperties;
+                bodySettings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
+                
+                bodySettings.mAllowSleeping = rb3d.AllowSleep;
+                bodySettings.mLinearDamping = rb3d.LinearDrag;
+                bodySettings.mAngularDamping = rb3d.AngularDrag;
+                bodySettings.mGravityFactor = rb3d.GravityScale;
+                
+                JPH::Body* body = bodyInterface.CreateBody(bodySettings);
+                
+                // runs out of bodies when the scene has more than PhysicsSettings::Capacity3D.MaxBodies
+                rb3d.RuntimeBody = body;
+                bodyIDs[i] = body ? body->GetID() : JPH::BodyID();
+            }
+        });
+        
+        // awake bodies first, each group is added with a single activation mode
+        std::vector<JPH::BodyID> addedIDs;
+        addedIDs.reserve(bodyIDs.size());
+        
+        size_t awakeCount = 0;
+        for (int awake = 1; awake >= 0; awake--)
+        {
+            for (size_t i = 0; i < handles.size(); i++)
+            {
+                if (!bodyIDs[i].IsInvalid() && m_Registry.get<RigidBody3DComponent>(handles[i]).Awake == (bool)awake) {
+                    addedIDs.push_back(bodyIDs[i]);
+                }
+            }
+            
+            if (awake) {
+                awakeCount = addedIDs.size();
+            }
+        }
+        
+        if (addedIDs.size() < handles.size()) {
+            SP_LOG_ERORR("Scene::OnRuntimeStart only {0} of {1} 3D bodies could be created, increase the max bodies of the physics settings", addedIDs.size(), handles.size());
+        }
+        
+        if (invalidShapes > 0) {
+            SP_LOG_WARN("Scene::OnRuntimeStart {0} 3D colliders could not be created (zero scale or size?), their bodies were created without them", invalidShapes.load());
+        }
+        
+        if (invalidLayers > 0) {
+            SP_LOG_WARN("Scene::OnRuntimeStart {0} 3D bodies use a layer missing from the collision matrix, moved to the Default layer", invalidLayers.load());
+        }
+        
+        // bulk insert: every batch builds its own broadphase tree (in parallel), finalize only links the trees.
+        // this is a lot faster than adding the bodies one by one and leaves the broadphase optimized, OptimizeBroadPhase() is not needed
+        struct AddBatch
+        {
+            size_t Begin = 0;
+            size_t Count = 0;
+            JPH::EActivation Activation = JPH::EActivation::DontActivate;
+            JPH::BodyInterface::AddState State = nullptr;
+        };
+        
+        constexpr size_t batchSize = 4096;
+        
+        std::vector<AddBatch> batches;
+        for (size_t begin = 0; begin < awakeCount; begin += batchSize) {
+            batches.push_back({begin, std::min(batchSize, awakeCount - begin), JPH::EActivation::Activate});
+        }
+        for (size_t begin = awakeCount; begin < addedIDs.size(); begin += batchSize) {
+            batches.push_back({begin, std::min(batchSize, addedIDs.size() - begin), JPH::EActivation::DontActivate});
+        }
+        
+        JobSystem::ParallelFor((uint32_t)batches.size(), [&](uint32_t index) {
+            AddBatch& batch = batches[index];
+            batch.State = bodyInterface.AddBodiesPrepare(&addedIDs[batch.Begin], (int)batch.Count);
+        });
+        
+        for (AddBatch& batch : batches) {
+            bodyInterface.AddBodiesFinalize(&addedIDs[batch.Begin], (int)batch.Count, batch.State, batch.Activation);
+        }
+        
+        // drop the shapes of colliders that were removed or changed since the last play session
+        shapeCache.Prune();
+        
+        const ShapeCache3D::Stats shapeStats = shapeCache.GetStats();
+        m_PhysicsStats.Bodies3D = addedIDs.size();
+        m_PhysicsStats.CachedShapes = shapeStats.Shapes;
+        m_PhysicsStats.ShapeCacheHits = shapeStats.Hits;
+        m_PhysicsStats.ShapeCacheMisses = shapeStats.Misses;
+        
+        // dense BodyID -> entity mapping, the body index is always smaller than the max bodies of the world
+        m_BodyEntities3D.assign(m_PhysicsWorld3D->GetCapacity().MaxBodies, entt::null);
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            if (!bodyIDs[i].IsInvalid()) {
+                m_BodyEntities3D[bodyIDs[i].GetIndex()] = handles[i];
+            }
+        }
+        
+        m_MovingBodies3D.clear();
+        m_StoppedBodies3D.clear();
+        
+        // structural changes to the registry are not thread safe, the interpolation states are added afterwards
+        for (entt::entity handle : handles)
+        {
+            Vector3 translation, scale;
+            Quaternion rotation;
+            GetWorldPose(m_Registry.get<TransformComponent>(handle), m_Registry.get<WorldTransformComponent>(handle), &translation, &rotation, &scale);
+            
+            auto& state = m_Registry.emplace_or_replace<PhysicsInterpolationComponent>(handle);
+            state.PreviousTranslation = state.CurrentTranslation = translation;
+            state.PreviousRotation = state.CurrentRotation = rotation;
         }
     }
 
     void Scene::OnRuntimeEnd()
     {
+        // lua scripts, before the physics is torn down so OnDestroy can still use it
+        {
+            auto view = m_Registry.view<LuaScriptComponent>();
+            for (auto handle : view)
+            {
+                Entity entt = {handle, this};
+                ScriptingEngine::OnDestroy(entt);
+            }
+            
+            ScriptingEngine::OnRuntimeEnd();
+            
+            // the released script instances, before the next scene starts
+            ScriptingEngine::CollectGarbageFull();
+        }
+        
         // 3D physics
         {
-            JPH::BodyInterface& bodyInterface = PhysicsEngine3D::GetPhysicsSystem().GetBodyInterface();
+            JPH::BodyInterface& bodyInterface = m_PhysicsWorld3D->GetPhysicsSystem().GetBodyInterface();
+            
+            std::vector<JPH::BodyID> bodyIDs;
             
             auto view = m_Registry.view<RigidBody3DComponent>();
             for (auto handle : view)
             {
-                Entity entt = {handle, this};
-                
-                auto& rb3d = entt.GetComponent<RigidBody3DComponent>();
+                auto& rb3d = view.get<RigidBody3DComponent>(handle);
                 
                 if (rb3d.RuntimeBody)
                 {
-                    JPH::Body* body = (JPH::Body*)rb3d.RuntimeBody;
-                    bodyInterface.RemoveBody(body->GetID());
-                    bodyInterface.DestroyBody(body->GetID());
-                    
+                    bodyIDs.push_back(((JPH::Body*)rb3d.RuntimeBody)->GetID());
                     rb3d.RuntimeBody = nullptr;
                 }
             }
             
-            PhysicsEngine3D::Shutdown();
+            // batched as well, one broadphase update for all the bodies
+            if (!bodyIDs.empty())
+            {
+                bodyInterface.RemoveBodies(bodyIDs.data(), (int)bodyIDs.size());
+                bodyInterface.DestroyBodies(bodyIDs.data(), (int)bodyIDs.size());
+            }
         }
         
         
@@ -205,11 +589,45 @@ namespace Spectral {
             m_PhysicsWorld = nullptr;
         }
         
-        // @TODO: script on destroy
-        /*m_Registry.view<NativeScriptComponent>().each([=](auto entity, auto& nsc) {
-         //ScriptingEngine::OnDestroy(entity);
-        });
-        */
+        m_Registry.clear<PhysicsInterpolationComponent>();
+        m_BodyEntities3D.clear();
+        m_MovingBodies3D.clear();
+        m_StoppedBodies3D.clear();
+        m_Bodies2D.clear();
+        m_MovingBodies2D.clear();
+        m_StoppedBodies2D.clear();
+        m_PhysicsAccumulator = 0.0f;
+        
+        ScriptingEngine::SetPhysicsQuery(nullptr);
+    }
+
+    uint32_t Scene::ReloadChangedScripts()
+    {
+        uint32_t reloaded = 0;
+        
+        // checked once per script and lua state: the first reload updates the cache of the state, the other instances would look up to date
+        std::map<std::pair<std::string, int32_t>, bool> changedScripts;
+        
+        auto view = m_Registry.view<LuaScriptComponent>();
+        for (auto handle : view)
+        {
+            const auto& lsc = view.get<LuaScriptComponent>(handle);
+            
+            auto [it, inserted] = changedScripts.try_emplace({lsc.ScriptPath, lsc.Worker}, false);
+            if (inserted) {
+                it->second = ScriptingEngine::HasScriptChanged({handle, this});
+            }
+            
+            if (it->second && ScriptingEngine::ReloadScript({handle, this})) {
+                reloaded++;
+            }
+        }
+        
+        if (reloaded > 0) {
+            SP_LOG_INFO("Scene::ReloadChangedScripts - {0} script instance(s) reloaded", reloaded);
+        }
+        
+        return reloaded;
     }
 
     void Scene::OnUpdateRuntime(Timestep ts)
@@ -218,129 +636,323 @@ namespace Spectral {
         
         // update scripts
         {
-            // lua scripts
+            // lua scripts, the ones that are not parallel safe run one after the other on the main lua state
             auto view = m_Registry.view<LuaScriptComponent>();
             for (auto handle : view)
             {
-                Entity entt = {handle, this};
-                ScriptingEngine::OnUpdate(entt, ts);
+                // scripts without OnUpdate are skipped entirely
+                const auto& lsc = view.get<LuaScriptComponent>(handle);
+                if (lsc.Worker < 0 && lsc.Batch < 0 && lsc.UpdateFunction.valid())
+                {
+                    Entity entt = {handle, this};
+                    ScriptingEngine::OnUpdate(entt, ts);
+                }
             }
-        }
-        
-        // update physics
-        {
-            // @TODO: Use custom physicsTs for physics 2D and 3D
-            
-            PhysicsEngine3D::StepPhysics(ts);
-            
-            // using fewer iterations increases performance but accuracy gonna suffer
-            // @NOTE: maybe expose to some physics setting to change the precision
-            const int32_t velocityIteration = 6;
-            const int32_t positionIteration = 2;
-            m_PhysicsWorld->Step(ts, velocityIteration, positionIteration);
-            
             
-            // update 3D physics
+            // scripts with OnUpdateAll, one call per script type (collected after the serial scripts, they may add or remove entities)
+            const uint32_t batchCount = ScriptingEngine::GetBatchCount();
+            if (batchCount > 0)
             {
-                const auto& bodyInterface = PhysicsEngine3D::GetPhysicsSystem().GetBodyInterface();
+                m_ScriptBatchEntities.resize(batchCount);
+                for (auto& entities : m_ScriptBatchEntities) {
+                    entities.clear();
+                }
                 
-                auto view = m_Registry.view<RigidBody3DComponent>();
                 for (auto handle : view)
                 {
-                    Entity entt = {handle, this};
-                    
-                    auto& rb3d = entt.GetComponent<RigidBody3DComponent>();
-                    auto& transform = entt.GetComponent<TransformComponent>();
-                    
-                    JPH::Body* body = (JPH::Body*)rb3d.RuntimeBody;
-                    
-                    if (!bodyInterface.IsActive(body->GetID())) {
-                        continue;
+                    const auto& lsc = view.get<LuaScriptComponent>(handle);
+                    if (lsc.Batch >= 0) {
+                        m_ScriptBatchEntities[lsc.Batch].push_back(handle);
                     }
-                        
-                    JPH::Vec3 position = body->GetPosition();
-                    JPH::Vec3 rotation = body->GetRotation().GetEulerAngles();
-                    
-                    transform.Translation = {position.GetX(), position.GetY(), position.GetZ()};
-                    transform.Rotation = {rotation.GetX(), rotation.GetY(), rotation.GetZ()};
                 }
-
+                
+                ScriptingEngine::OnUpdateBatches(this, m_ScriptBatchEntities, ts);
             }
             
-            // update 2D physics
+            // parallel safe scripts, grouped by worker lua state (after the serial ones, they may add or remove entities)
+            const uint32_t workerCount = ScriptingEngine::GetWorkerCount();
+            if (workerCount > 0)
             {
-                auto view = m_Registry.view<RigidBody2DComponent>();
+                m_ScriptWorkerEntities.resize(workerCount);
+                for (auto& entities : m_ScriptWorkerEntities) {
+                    entities.clear();
+                }
+                
                 for (auto handle : view)
                 {
-                    Entity entt = {handle, this};
-                    
-                    auto& rb2d = entt.GetComponent<RigidBody2DComponent>();
-                    auto& transform = entt.GetComponent<TransformComponent>();
-                    
-                    b2Body* body = (b2Body*)rb2d.RuntimeBody;
-                    
-                    const auto& position = body->GetPosition();
-                    transform.Translation.x = position.x;
-                    transform.Translation.y = position.y;
-                    transform.Rotation.z = body->GetAngle();
+                    const auto& lsc = view.get<LuaScriptComponent>(handle);
+                    if (lsc.Worker >= 0 && lsc.UpdateFunction.valid()) {
+                        m_ScriptWorkerEntities[lsc.Worker].push_back(handle);
+                    }
                 }
+                
+                // the bindings must not create pools from the jobs (see ScriptGlue::RegisterMetaFunctions)
+                m_Registry.storage<TransformComponent>();
+                m_Registry.storage<RigidBody2DComponent>();
+                
+                ScriptingEngine::OnUpdateParallel(this, m_ScriptWorkerEntities, ts);
             }
         }
         
+        // update physics
+        UpdatePhysics(ts);
+        
+        UpdateWorldTransforms();
+        
         // update camera
         {
-            auto view = m_Registry.view<TransformComponent, CameraComponent>();
+            auto view = m_Registry.view<WorldTransformComponent, CameraComponent>();
             for (auto handle : view)
             {
-                auto [transform, camera] = view.get<TransformComponent, CameraComponent>(handle);
+                auto [transform, camera] = view.get<WorldTransformComponent, CameraComponent>(handle);
                 
                 if (camera.Active) {
                     m_RuntimeCamera = camera.Camera;
-                    m_RuntimeCamera->SetTransform(transform.GetTransform());
+                    m_RuntimeCamera->SetTransform(transform.Transform);
                 } else {
                     m_RuntimeCamera = nullptr;
                 }
             }
         }
+        
+        // lua garbage, once the scripts are done for this frame (within the budget, see ScriptingEngine::GCSettings)
+        ScriptingEngine::CollectGarbage();
     }
 
-    void Scene::OnRenderRuntime()
+    void Scene::UpdatePhysics(Timestep ts)
     {
-        if (m_RuntimeCamera)
+        // fixed timestep: the simulation result does not depend on the frame rate
+        const float fixedTimestep = m_PhysicsSettings.FixedTimestep;
+        
+        // using fewer iterations increases performance but accuracy gonna suffer
+        // @NOTE: maybe expose to some physics setting to change the precision
+        const int32_t velocityIteration = 6;
+        const int32_t positionIteration = 2;
+        
+        m_PhysicsAccumulator += ts;
+        
+        uint32_t steps = 0;
+        while (m_PhysicsAccumulator >= fixedTimestep && steps < m_PhysicsSettings.MaxSubSteps)
         {
-            BeginMode3DM(m_RuntimeCamera->GetCamera3D(), m_RuntimeCamera->GetTransform());
+            m_PhysicsWorld3D->Step(fixedTimestep);
+            m_PhysicsWorld->Step(fixedTimestep, velocityIteration, positionIteration);
             
-                // draw sprites
-                {
-                    auto view = m_Registry.view<TransformComponent, SpriteComponent>();
-                    for (auto handle : view)
-                    {
-                        auto [transform, sprite] = view.get<TransformComponent, SpriteComponent>(handle);
-                    
-                        Renderer::RenderTexturedPlane(sprite.SpriteTexture, transform.GetTransform(), sprite.Tint);
-                    }
+            StorePhysicsStates();
+            
+            m_PhysicsAccumulator -= fixedTimestep;
+            steps++;
+        }
+        
+        // frame spike: drop the time that could not be simulated, otherwise every following frame falls further behind
+        if (m_PhysicsAccumulator >= fixedTimestep) {
+            m_PhysicsAccumulator = std::fmod(m_PhysicsAccumulator, fixedTimestep);
+        }
+        
+        const float alpha = m_PhysicsSettings.Interpolate ? m_PhysicsAccumulator / fixedTimestep : 1.0f;
+        ApplyPhysicsInterpolation(alpha);
+    }
+
+    void Scene::StorePhysicsStates()
+    {
+        // 3D physics, only the bodies Jolt keeps in its active list are touched, sleeping bodies cost nothing
+        {
+            // @NOTE: the simulation is done, nothing else changes the bodies while the states are stored, no locking needed
+            const JPH::PhysicsSystem& physicsSystem = m_PhysicsWorld3D->GetPhysicsSystem();
+            
+            // bodies that fell asleep during the step snap to their final pose
+            for (entt::entity handle : m_MovingBodies3D)
+            {
+                if (!m_Registry.all_of<RigidBody3DComponent, PhysicsInterpolationComponent>(handle)) {
+                    continue;
                 }
+                
+                const JPH::Body* body = (const JPH::Body*)m_Registry.get<RigidBody3DComponent>(handle).RuntimeBody;
+                if (body->IsActive()) {
+                    continue;
+                }
+                
+                auto& state = m_Registry.get<PhysicsInterpolationComponent>(handle);
+                
+                JPH::Vec3 position = body->GetPosition();
+                JPH::Quat rotation = body->GetRotation();
+                
+                state.PreviousTranslation = state.CurrentTranslation = {position.GetX(), position.GetY(), position.GetZ()};
+                state.PreviousRotation = state.CurrentRotation = {rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW()};
+                state.Moving = false;
+                
+                m_StoppedBodies3D.push_back(handle);
+            }
             
-                // draw 3D models
+            // BodyID -> entity through the dense array filled by CreateBodies3D()
+            const uint32_t activeCount = physicsSystem.GetNumActiveBodies(JPH::EBodyType::RigidBody);
+            const JPH::BodyID* activeIDs = physicsSystem.GetActiveBodiesUnsafe(JPH::EBodyType::RigidBody);
+            
+            m_MovingBodies3D.clear();
+            for (uint32_t i = 0; i < activeCount; i++)
+            {
+                const uint32_t index = activeIDs[i].GetIndex();
+                
+                if (index >= m_BodyEntities3D.size()) {
+                    continue;
+                }
+                
+                // the entity of a removed body is reset by OnRigidBody3DDestroy()
+                const entt::entity handle = m_BodyEntities3D[index];
+                if (m_Registry.all_of<RigidBody3DComponent, PhysicsInterpolationComponent>(handle)) {
+                    m_MovingBodies3D.push_back(handle);
+                }
+            }
+            
+            JobSystem::ParallelForRange(m_MovingBodies3D.size(), 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    const entt::entity handle = m_MovingBodies3D[i];
+                    const JPH::Body* body = (const JPH::Body*)m_Registry.get<RigidBody3DComponent>(handle).RuntimeBody;
+                    auto& state = m_Registry.get<PhysicsInterpolationComponent>(handle);
+                    
+                    JPH::Vec3 position = body->GetPosition();
+                    JPH::Quat rotation = body->GetRotation();
+                    
+                    state.PreviousTranslation = state.CurrentTranslation;
+                    state.PreviousRotation = state.CurrentRotation;
+                    state.CurrentTranslation = {position.GetX(), position.GetY(), position.GetZ()};
+                    state.CurrentRotation = {rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW()};
+                    state.Moving = true;
+                }
+            });
+        }
+        
+        // 2D physics, Box2D has no list of awake bodies, the dense array of the non static bodies is walked instead.
+        // static bodies never move and are not part of it, only the sleep flag of the others is checked
+        {
+            m_MovingBodies2D.clear();
+            
+            for (Body2D& entry : m_Bodies2D)
+            {
+                if (entry.Body->IsAwake())
                 {
-                    auto view = m_Registry.view<TransformComponent, ModelComponent>();
-                    for (auto handle : view)
+                    entry.Moving = true;
+                    m_MovingBodies2D.push_back(entry.Entity);
+                    continue;
+                }
+                
+                // bodies that fell asleep during the step snap to their final pose
+                if (entry.Moving)
+                {
+                    entry.Moving = false;
+                    
+                    if (auto* state = m_Registry.try_get<PhysicsInterpolationComponent>(entry.Entity))
                     {
-                        auto [transform, model] = view.get<TransformComponent, ModelComponent>(handle);
-
-                        model.ModelData.transform = transform.GetTransform();
+                        const auto& position = entry.Body->GetPosition();
+                        state->PreviousTranslation = state->CurrentTranslation = {position.x, position.y, 0.0f};
+                        state->PreviousRotation = state->CurrentRotation = QuaternionFromAxisAngle({0.0f, 0.0f, 1.0f}, entry.Body->GetAngle());
+                        state->Moving = false;
                         
-                        // @Note: do not modify position and scale values here, the transform matrix is paased from a model
-                        
-                        // @TODO: temp solution
-                        Color color;
-                        color.r = model.Tint.x * 255.0f;
-                        color.g = model.Tint.y * 255.0f;
-                        color.b = model.Tint.z * 255.0f;
-                        color.a = model.Tint.w * 255.0f;
-                        DrawModel(model.ModelData, (Vector3){0.0f, 0.0f, 0.0f}, 1.0f, color);
+                        m_StoppedBodies2D.push_back(entry.Entity);
                     }
                 }
+            }
+            
+            JobSystem::ParallelForRange(m_MovingBodies2D.size(), 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    const entt::entity handle = m_MovingBodies2D[i];
+                    
+                    // skips entities that were removed while the scene is running
+                    auto* state = m_Registry.try_get<PhysicsInterpolationComponent>(handle);
+                    auto* rb2d = m_Registry.try_get<RigidBody2DComponent>(handle);
+                    if (!state || !rb2d) {
+                        continue;
+                    }
+                    
+                    const b2Body* body = (const b2Body*)rb2d->RuntimeBody;
+                    const auto& position = body->GetPosition();
+                    
+                    state->PreviousTranslation = state->CurrentTranslation;
+                    state->PreviousRotation = state->CurrentRotation;
+                    state->CurrentTranslation = {position.x, position.y, 0.0f}; // z is not simulated, it is never written back
+                    state->CurrentRotation = QuaternionFromAxisAngle({0.0f, 0.0f, 1.0f}, body->GetAngle());
+                    state->Moving = true;
+                }
+            });
+        }
+    }
+
+    void Scene::ApplyPhysicsInterpolation(float alpha)
+    {
+        // 3D physics, bodies that stopped first, one of them may have been woken up again by a later sub step
+        {
+            auto writeTransform = [this](entt::entity handle, float alpha) {
+                // the entity may have been removed by a script since the last physics step
+                if (!m_Registry.all_of<TransformComponent, PhysicsInterpolationComponent>(handle)) {
+                    return;
+                }
+                
+                auto& transform = m_Registry.get<TransformComponent>(handle);
+                const auto& state = m_Registry.get<PhysicsInterpolationComponent>(handle);
+                
+                // straight quaternion copy, no euler conversion in the hot path
+                SetWorldPose(m_Registry, handle, transform, Vector3Lerp(state.PreviousTranslation, state.CurrentTranslation, alpha),
+                             QuaternionSlerp(state.PreviousRotation, state.CurrentRotation, alpha));
+            };
+            
+            for (entt::entity handle : m_StoppedBodies3D) {
+                writeTransform(handle, 1.0f);
+            }
+            m_StoppedBodies3D.clear();
+            
+            JobSystem::ParallelForRange(m_MovingBodies3D.size(), 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    writeTransform(m_MovingBodies3D[i], alpha);
+                }
+            });
+        }
+        
+        // 2D physics, same as 3D
+        {
+            auto writeTransform = [this](entt::entity handle, float alpha) {
+                if (!m_Registry.all_of<TransformComponent, PhysicsInterpolationComponent>(handle)) {
+                    return;
+                }
+                
+                auto& transform = m_Registry.get<TransformComponent>(handle);
+                const auto& state = m_Registry.get<PhysicsInterpolationComponent>(handle);
+                
+                // 2D bodies only rotate around z, on top of the x/y rotation of the entity (z * y * x like QuaternionFromEuler)
+                const Quaternion rotation = QuaternionMultiply(QuaternionSlerp(state.PreviousRotation, state.CurrentRotation, alpha), state.BaseRotation);
+                const float x = Lerp(state.PreviousTranslation.x, state.CurrentTranslation.x, alpha);
+                const float y = Lerp(state.PreviousTranslation.y, state.CurrentTranslation.y, alpha);
+                
+                // z is not simulated, roots keep their own, children the world z of their last pose
+                const auto& world = m_Registry.get<WorldTransformComponent>(handle);
+                const float z = world.Parent == entt::null ? transform.Translation.z : world.Transform.m14;
+                SetWorldPose(m_Registry, handle, transform, {x, y, z}, rotation);
+            };
+            
+            for (entt::entity handle : m_StoppedBodies2D) {
+                writeTransform(handle, 1.0f);
+            }
+            m_StoppedBodies2D.clear();
+            
+            JobSystem::ParallelForRange(m_MovingBodies2D.size(), 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    writeTransform(m_MovingBodies2D[i], alpha);
+                }
+            });
+        }
+    }
+
+    void Scene::OnRenderRuntime()
+    {
+        if (m_RuntimeCamera)
+        {
+            BeginMode3DM(m_RuntimeCamera->GetCamera3D(), m_RuntimeCamera->GetTransform());
+            
+                // extract the frustum from the matrices the 3D mode just set up, so culling matches what is drawn
+                Math::Frustum frustum;
+                Math::ExtractFrustrum(rlGetMatrixProjection(), rlGetMatrixModelview(), &frustum);
+            
+                RenderEntities(frustum, false);
             
             EndMode3D();
         }
@@ -348,6 +960,7 @@ namespace Spectral {
 
     void Scene::OnUpdateEditor(Timestep ts)
     {
+        UpdateWorldTransforms();
     }
 
     void Scene::OnRenderEditor(EditorCamera& camera)
@@ -357,58 +970,476 @@ namespace Spectral {
             // draw grid
             DrawGrid(20, 10.0f);
         
-            // draw sprites
+            Math::Frustum frustum;
+            Math::ExtractFrustrum(rlGetMatrixProjection(), rlGetMatrixModelview(), &frustum);
+        
+            RenderEntities(frustum, true);
+        
+            // draw camera debug
             {
-                auto view = m_Registry.view<TransformComponent, SpriteComponent>();
+                auto view = m_Registry.view<CameraComponent>();
                 for (auto handle : view)
                 {
-                    auto [transform, sprite] = view.get<TransformComponent, SpriteComponent>(handle);
-                    
-                    Renderer::RenderTexturedPlane(sprite.SpriteTexture, transform.GetTransform(), sprite.Tint);
+                    Entity entt = {handle, this};
+                    auto& cameraComponent = entt.GetComponent<CameraComponent>();
                     
-                    // @DEBUG
-                    DrawCubeWiresM(transform.GetTransform(), (Vector3){50.0f, 50.0f ,1.0f}, VIOLET);
+                    if (cameraComponent.Debug) {
+                        Renderer::RenderCameraDebugLines(cameraComponent.Camera, VIOLET);
+                    }
                 }
             }
         
-            // draw 3D models
+        EndMode3D();
+    }
+
+    static bool TransformEquals(const TransformComponent& a, const TransformComponent& b)
+    {
+        // exact compare on purpose, any change has to invalidate the cached matrix
+        return std::memcmp(&a, &b, sizeof(TransformComponent)) == 0;
+    }
+
+    void Scene::OnTransformConstruct(entt::registry& /*registry*/, entt::entity handle)
+    {
+        // new entities are always roots, so they can be appended without resorting
+        if (!m_TransformOrderDirty)
+        {
+            m_TransformRanges.push_back({m_TransformOrder.size(), 1});
+            m_TransformOrder.push_back(handle);
+        }
+    }
+
+    void Scene::OnTransformDestroy(entt::registry& /*registry*/, entt::entity handle)
+    {
+        m_SpatialIndex.Remove(handle);
+        m_TransformOrderDirty = true;
+    }
+
+    void Scene::OnBoundsDestroy(entt::registry& registry, entt::entity handle)
+    {
+        const int32_t proxy = registry.get<BoundsComponent>(handle).TreeProxy;
+        if (proxy != DynamicBVH::NullNode) {
+            m_BoundsTree.Remove(proxy);
+        }
+    }
+
+    void Scene::OnRigidBody3DDestroy(entt::registry& registry, entt::entity handle)
+    {
+        // entity (or component) removed while the scene is running: the world is kept between play sessions, the body
+        // would stay in it, keep colliding and hold one of the max bodies
+        auto& rb3d = registry.get<RigidBody3DComponent>(handle);
+        if (!rb3d.RuntimeBody || !m_PhysicsWorld3D) {
+            return;
+        }
+        
+        JPH::BodyInterface& bodyInterface = m_PhysicsWorld3D->GetPhysicsSystem().GetBodyInterface();
+        const JPH::BodyID bodyID = ((const JPH::Body*)rb3d.RuntimeBody)->GetID();
+        
+        if (bodyInterface.IsAdded(bodyID)) {
+            bodyInterface.RemoveBody(bodyID);
+        }
+        bodyInterface.DestroyBody(bodyID);
+        
+        if (bodyID.GetIndex() < m_BodyEntities3D.size()) {
+            m_BodyEntities3D[bodyID.GetIndex()] = entt::null;
+        }
+        
+        rb3d.RuntimeBody = nullptr;
+        m_PhysicsStats.Bodies3D--;
+    }
+
+    void Scene::RebuildTransformOrder()
+    {
+        auto& storage = m_Registry.storage<WorldTransformComponent>();
+        
+        // resolve parent, root and depth of every transform
+        for (auto [handle, world] : storage.each())
+        {
+            const auto* relationship = m_Registry.try_get<RelationshipComponent>(handle);
+            
+            world.Parent = relationship ? relationship->Parent : entt::null;
+            world.Root = handle;
+            world.Depth = 0;
+            
+            for (entt::entity parent = world.Parent; parent != entt::null;)
             {
-                auto view = m_Registry.view<TransformComponent, ModelComponent>();
-                for (auto handle : view)
+                world.Root = parent;
+                world.Depth++;
+                
+                const auto* parentRelationship = m_Registry.try_get<RelationshipComponent>(parent);
+                parent = parentRelationship ? parentRelationship->Parent : entt::null;
+            }
+        }
+        
+        // group every subtree together and order it by depth, so parents are always updated before their children
+        m_Registry.sort<WorldTransformComponent>([](const WorldTransformComponent& lhs, const WorldTransformComponent& rhs) {
+            if (lhs.Root != rhs.Root) {
+                return entt::to_integral(lhs.Root) < entt::to_integral(rhs.Root);
+            }
+            return lhs.Depth < rhs.Depth;
+        });
+        
+        // keep the local transforms in the same order, the propagation then walks both pools linearly
+        m_Registry.sort<TransformComponent, WorldTransformComponent>();
+        
+        m_TransformOrder.clear();
+        m_TransformRanges.clear();
+        m_TransformOrder.reserve(storage.size());
+        
+        for (auto [handle, world] : storage.each())
+        {
+            if (world.Depth == 0) {
+                m_TransformRanges.push_back({m_TransformOrder.size(), 0});
+            }
+            
+            m_TransformOrder.push_back(handle);
+            m_TransformRanges.back().Count++;
+        }
+        
+        m_TransformOrderDirty = false;
+    }
+
+    void Scene::PropagateTransforms(size_t begin, size_t end, std::vector<entt::entity>& moved)
+    {
+        // @NOTE: transforms are written through plain references (editor, lua, physics), so a change is detected
+        // by comparing against the transform the matrix was built from, unchanged subtrees cost no matrix math
+        for (size_t i = begin; i < end; i++)
+        {
+            const entt::entity handle = m_TransformOrder[i];
+            
+            const auto& transform = m_Registry.get<TransformComponent>(handle);
+            auto& world = m_Registry.get<WorldTransformComponent>(handle);
+            
+            const bool localChanged = !world.Valid || !TransformEquals(world.CachedTransform, transform);
+            
+            if (localChanged)
+            {
+                world.Local = transform.GetTransform();
+                world.CachedTransform = transform;
+            }
+            
+            // parent is earlier in the order, so its world matrix is already up to date
+            const WorldTransformComponent* parentWorld = (world.Parent != entt::null) ? &m_Registry.get<WorldTransformComponent>(world.Parent) : nullptr;
+            const uint32_t parentVersion = parentWorld ? parentWorld->Version : 0;
+            
+            if (!localChanged && world.CachedParentVersion == parentVersion) {
+                continue;
+            }
+            
+            world.Transform = parentWorld ? MatrixMultiply(world.Local, parentWorld->Transform) : world.Local;
+            world.CachedParentVersion = parentVersion;
+            world.Version++;
+            world.Valid = true;
+            
+            moved.push_back(handle);
+        }
+    }
+
+    void Scene::UpdateWorldTransforms()
+    {
+        if (m_TransformOrderDirty) {
+            RebuildTransformOrder();
+        }
+        
+        // each range is independent from the others (one root and its subtree), so they are processed in parallel
+        static constexpr size_t s_RootsPerJob = 256;
+        
+        m_MovedTransforms.resize(JobSystem::GetThreadCount());
+        for (auto& moved : m_MovedTransforms) {
+            moved.clear();
+        }
+        
+        JobSystem::ParallelForRange(m_TransformRanges.size(), s_RootsPerJob, [this](size_t begin, size_t end) {
+            // a thread only runs one job at a time, so its list needs no locking
+            auto& moved = m_MovedTransforms[JobSystem::GetThreadIndex()];
+            
+            for (size_t i = begin; i < end; i++) {
+                PropagateTransforms(m_TransformRanges[i].Begin, m_TransformRanges[i].Begin + m_TransformRanges[i].Count, moved);
+            }
+        });
+        
+        UpdateSpatialIndex();
+    }
+
+    void Scene::UpdateSpatialIndex()
+    {
+        // only the entities whose world matrix was rebuilt, boxes that stay in their cell are overwritten in place
+        for (const auto& moved : m_MovedTransforms)
+        {
+            for (auto handle : moved)
+            {
+                const Matrix& transform = m_Registry.get<WorldTransformComponent>(handle).Transform;
+                const auto* bounds = m_Registry.try_get<BoundsComponent>(handle);
+                
+                // the local bounds are computed by BuildRenderQueue(), until then (or without sprite/model) the entity is a point
+                if (bounds && bounds->Valid)
                 {
-                    auto [transform, model] = view.get<TransformComponent, ModelComponent>(handle);
-                    
-                    model.ModelData.transform = transform.GetTransform();
-                    
-                    // @Note: do not modify position and scale values here, the transform matrix is paased from a model
-                    
-                    // @TODO: temp solution
-                    Color color;
-                    color.r = model.Tint.x * 255.0f;
-                    color.g = model.Tint.y * 255.0f;
-                    color.b = model.Tint.z * 255.0f;
-                    color.a = model.Tint.w * 255.0f;
-                    DrawModel(model.ModelData, (Vector3){0.0f, 0.0f, 0.0f}, 1.0f, color);
-                    
-                    // @DEBUG
-                    ///DrawBoundingBox(GetMeshBoundingBox(model.ModelData.meshes[0]), VIOLET);
+                    m_SpatialIndex.Update(handle, Math::TransformBoundingBox(bounds->LocalBounds, transform));
+                }
+                else
+                {
+                    const Vector3 position = {transform.m12, transform.m13, transform.m14};
+                    m_SpatialIndex.Update(handle, (BoundingBox){position, position});
                 }
             }
+        }
+    }
+
+    void Scene::AddMissingBounds()
+    {
+        // every sprite/model entity gets bounds, they are kept until the entity is destroyed
+        std::vector<entt::entity> missing;
         
-            // draw camera debug
+        for (auto handle : m_Registry.view<SpriteComponent>(entt::exclude<BoundsComponent>)) {
+            missing.push_back(handle);
+        }
+        for (auto handle : m_Registry.view<ModelComponent>(entt::exclude<BoundsComponent>)) {
+            missing.push_back(handle);
+        }
+        for (auto handle : missing) {
+            m_Registry.emplace_or_replace<BoundsComponent>(handle);
+        }
+    }
+
+    void Scene::BuildRenderChunk(RenderChunk& chunk, const entt::entity* begin, const entt::entity* end, const Math::Frustum& frustum, const Vector3& viewPosition)
+    {
+        // @NOTE: runs on a worker thread, only components of the entities in [begin, end) are written
+        chunk.Culler.Clear();
+        chunk.Culler.Reserve(end - begin);
+        chunk.MovedBounds.clear();
+        
+        for (const entt::entity* it = begin; it != end; it++)
+        {
+            const entt::entity handle = *it;
+            
+            auto& bounds = m_Registry.get<BoundsComponent>(handle);
+            const auto* world = m_Registry.try_get<WorldTransformComponent>(handle);
+            if (!world) {
+                continue;
+            }
+            
+            const bool hasSprite = m_Registry.all_of<SpriteComponent>(handle);
+            const ModelComponent* model = m_Registry.try_get<ModelComponent>(handle);
+            const Mesh* meshes = model ? model->ModelData.meshes : nullptr;
+            
+            // local bounds only change when the sprite/model itself changes
+            if (!bounds.Valid || bounds.CachedSprite != hasSprite || bounds.CachedMeshes != meshes)
             {
-                auto view = m_Registry.view<CameraComponent>();
-                for (auto handle : view)
+                BoundingBox local = { 0 };
+                bool empty = true;
+                
+                if (hasSprite)
                 {
-                    Entity entt = {handle, this};
-                    auto& cameraComponent = entt.GetComponent<CameraComponent>();
+                    // sprite plane is always created on the XY-axis (see Renderer::RenderTexturedPlane)
+                    local = (BoundingBox){ {-25.0f, -25.0f, 0.0f}, {25.0f, 25.0f, 0.0f} };
+                    empty = false;
+                }
+                
+                if (model && model->ModelData.meshCount > 0)
+                {
+                    const BoundingBox modelBounds = Math::GetMeshesBoundingBox(model->ModelData);
+                    local = empty ? modelBounds : Math::MergeBoundingBoxes(local, modelBounds);
+                }
+                
+                bounds.LocalBounds = local;
+                bounds.CachedSprite = hasSprite;
+                bounds.CachedMeshes = meshes;
+                bounds.Valid = false; // force the world bounds to be recomputed
+            }
+            
+            // world bounds are only recomputed when the world matrix has been rebuilt since the last frame
+            if (!bounds.Valid || bounds.CachedWorldVersion != world->Version)
+            {
+                bounds.WorldBounds = Math::TransformBoundingBox(bounds.LocalBounds, world->Transform);
+                bounds.CachedWorldVersion = world->Version;
+                bounds.Valid = true;
+                
+                chunk.MovedBounds.push_back(handle);
+            }
+            
+            chunk.Culler.Add(handle, bounds.WorldBounds);
+        }
+        
+        const std::vector<entt::entity>& visible = chunk.Culler.Cull(frustum);
+        
+        chunk.Queue.Begin(viewPosition);
+        chunk.Queue.Reserve(visible.size());
+        
+        for (auto handle : visible)
+        {
+            const Matrix& transform = m_Registry.get<WorldTransformComponent>(handle).Transform;
+            
+            if (const SpriteComponent* sprite = m_Registry.try_get<SpriteComponent>(handle)) {
+                chunk.Queue.SubmitSprite(sprite->SpriteTexture, transform, sprite->Tint, sprite->Tint.w < 1.0f);
+            }
+            
+            if (const ModelComponent* model = m_Registry.try_get<ModelComponent>(handle))
+            {
+                // @TODO: temp solution
+                Color color;
+                color.r = model->Tint.x * 255.0f;
+                color.g = model->Tint.y * 255.0f;
+                color.b = model->Tint.z * 255.0f;
+                color.a = model->Tint.w * 255.0f;
+                
+                chunk.Queue.SubmitModel(model->ModelData, transform, color, model->Transparency);
+            }
+        }
+    }
+
+    void Scene::BuildRenderQueue(const Math::Frustum& frustum, const Vector3& viewPosition)
+    {
+        // structural changes are not allowed while the jobs are running
+        AddMissingBounds();
+        
+        // make sure every pool exists up front, the jobs must not create any
+        m_Registry.storage<WorldTransformComponent>();
+        m_Registry.storage<SpriteComponent>();
+        m_Registry.storage<ModelComponent>();
+        
+        const auto& storage = m_Registry.storage<BoundsComponent>();
+        const entt::entity* handles = storage.data();
+        const size_t count = storage.size();
+        
+        // a few chunks per thread so uneven chunks (e.g. all visible vs. all culled) still balance out
+        static constexpr size_t s_MinChunkSize = 1024;
+        const size_t chunkCount = std::min<size_t>((size_t)JobSystem::GetThreadCount() * 4, (count + s_MinChunkSize - 1) / s_MinChunkSize);
+        const size_t chunkSize = chunkCount > 0 ? (count + chunkCount - 1) / chunkCount : 0;
+        
+        if (m_RenderChunks.size() < chunkCount) {
+            m_RenderChunks.resize(chunkCount);
+        }
+        
+        JobSystem::ParallelFor((uint32_t)chunkCount, [&](uint32_t index) {
+            const size_t begin = index * chunkSize;
+            const size_t end = std::min(begin + chunkSize, count);
+            BuildRenderChunk(m_RenderChunks[index], handles + begin, handles + end, frustum, viewPosition);
+        });
+        
+        UpdateBoundsTree(chunkCount);
+        
+        // merge the thread local command lists, the payloads stay in the arenas of the chunks
+        m_RenderQueue.Begin(viewPosition);
+        m_RenderStats.RenderableEntities = 0;
+        m_RenderStats.VisibleEntities = 0;
+        
+        size_t commandCount = 0;
+        for (size_t i = 0; i < chunkCount; i++) {
+            commandCount += m_RenderChunks[i].Queue.GetCommands().size();
+        }
+        m_RenderQueue.Reserve(commandCount);
+        
+        for (size_t i = 0; i < chunkCount; i++)
+        {
+            m_RenderQueue.Append(m_RenderChunks[i].Queue);
+            m_RenderStats.RenderableEntities += m_RenderChunks[i].Culler.GetCandidateCount();
+            m_RenderStats.VisibleEntities += m_RenderChunks[i].Culler.GetVisibleCount();
+        }
+        
+        // sorting by state groups entities sharing the same model, so they end up in one instanced batch
+        m_RenderQueue.Sort();
+        m_RenderStats.RenderBatches = m_RenderQueue.GetBatches().size();
+        
+        m_RenderChunkCount = chunkCount;
+    }
+
+    void Scene::UpdateBoundsTree(size_t chunkCount)
+    {
+        // only the entities whose world bounds changed, leaves that stay inside their fat box are not even touched
+        for (size_t i = 0; i < chunkCount; i++)
+        {
+            for (auto handle : m_RenderChunks[i].MovedBounds)
+            {
+                auto& bounds = m_Registry.get<BoundsComponent>(handle);
+                
+                if (bounds.TreeProxy == DynamicBVH::NullNode) {
+                    bounds.TreeProxy = m_BoundsTree.Insert(handle, bounds.WorldBounds);
+                } else {
+                    m_BoundsTree.Move(bounds.TreeProxy, bounds.WorldBounds);
+                }
+                
+                // also picks up new local bounds (sprite/model changed) of entities that did not move
+                m_SpatialIndex.Update(handle, bounds.WorldBounds);
+            }
+        }
+    }
+
+    Entity Scene::PickEntity(const Ray& ray, RayCollision& collision)
+    {
+        collision = { 0 };
+        collision.distance = FLT_MAX;
+        entt::entity picked = entt::null;
+        
+        // nearest boxes first, the closest exact hit clips the ray so farther candidates are skipped
+        m_BoundsTree.QueryRay(ray, FLT_MAX, [&](entt::entity handle, float /*boxDistance*/) {
+            const auto* world = m_Registry.try_get<WorldTransformComponent>(handle);
+            if (!world) {
+                return collision.distance;
+            }
+            
+            if (m_Registry.all_of<SpriteComponent>(handle))
+            {
+                // same plane as Renderer::RenderTexturedPlane
+                const RayCollision hit = GetRayCollisionQuad(ray,
+                                                             Vector3Transform({-25.0f, -25.0f, 0.0f}, world->Transform),
+                                                             Vector3Transform({-25.0f,  25.0f, 0.0f}, world->Transform),
+                                                             Vector3Transform({ 25.0f,  25.0f, 0.0f}, world->Transform),
+                                                             Vector3Transform({ 25.0f, -25.0f, 0.0f}, world->Transform));
+                if (hit.hit && hit.distance < collision.distance)
+                {
+                    collision = hit;
+                    picked = handle;
+                }
+            }
+            
+            if (const ModelComponent* model = m_Registry.try_get<ModelComponent>(handle))
+            {
+                for (int i = 0; i < model->ModelData.meshCount; i++)
+                {
+                    const Mesh& mesh = model->ModelData.meshes[i];
+                    if (!mesh.vertices) {
+                        continue;
+                    }
                     
-                    if (cameraComponent.Debug) {
-                        Renderer::RenderCameraDebugLines(cameraComponent.Camera, VIOLET);
+                    const RayCollision hit = GetRayCollisionMesh(ray, mesh, world->Transform);
+                    if (hit.hit && hit.distance < collision.distance)
+                    {
+                        collision = hit;
+                        picked = handle;
                     }
                 }
             }
+            
+            return collision.distance;
+        });
         
-        EndMode3D();
+        if (picked == entt::null) {
+            collision = { 0 };
+            return {};
+        }
+        return { picked, this };
+    }
+
+    void Scene::RenderEntities(const Math::Frustum& frustum, bool debug)
+    {
+        // camera position is the translation of the inverted view matrix (set by BeginMode3D)
+        const Matrix inverseView = MatrixInvert(rlGetMatrixModelview());
+        
+        BuildRenderQueue(frustum, (Vector3){inverseView.m12, inverseView.m13, inverseView.m14});
+        
+        // GL calls only happen here, on the main thread
+        m_RenderStats.DrawCalls = Renderer::ExecuteRenderQueue(m_RenderQueue);
+        
+        if (debug)
+        {
+            for (size_t i = 0; i < m_RenderChunkCount; i++)
+            {
+                for (auto handle : m_RenderChunks[i].Culler.GetVisible())
+                {
+                    if (m_Registry.all_of<SpriteComponent>(handle)) {
+                        DrawCubeWiresM(m_Registry.get<WorldTransformComponent>(handle).Transform, (Vector3){50.0f, 50.0f ,1.0f}, VIOLET);
+                    }
+                }
+            }
+        }
     }
 }
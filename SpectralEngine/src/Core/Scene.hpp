@@ -11,10 +11,18 @@
 #include "Core/UUID.hpp"
 #include "Renderer/EditorCamera.hpp"
 #include "Renderer/RuntimeCamera.hpp"
+#include "Renderer/FrustumCuller.hpp"
+#include "Renderer/RenderQueue.hpp"
+#include "Math/DynamicBVH.hpp"
+#include "Math/SpatialIndex.hpp"
+#include "Physics/PhysicsWorld3D.hpp"
+#include "Physics/CollisionMatrix3D.hpp"
+#include "Physics/PhysicsQuery.hpp"
 
 #include "entt.hpp"
 
 class b2World;
+class b2Body;
 
 namespace Spectral {
 
@@ -23,16 +31,52 @@ namespace Spectral {
     class Scene
     {
     public:
-        Scene(const std::string& name) : m_Name(name) {}
-        ~Scene() = default;
+        struct RenderStats
+        {
+            size_t RenderableEntities = 0; // entities with a sprite or model
+            size_t VisibleEntities = 0;    // entities that passed frustum culling
+            size_t RenderBatches = 0;      // sorted commands grouped by mesh, material and tint (sprites are one batch each)
+            size_t DrawCalls = 0;          // one per mesh batch when instanced, one per mesh otherwise
+        };
+
+        struct PhysicsStats
+        {
+            size_t Bodies3D = 0;
+            size_t Bodies2D = 0;
+            size_t CachedShapes = 0;       // unique 3D collision shapes, shared by the bodies with identical colliders
+            uint64_t ShapeCacheHits = 0;   // of the last OnRuntimeStart()
+            uint64_t ShapeCacheMisses = 0;
+            
+            float GetShapeCacheHitRate() const { return ShapeCacheHits + ShapeCacheMisses > 0 ? (float)ShapeCacheHits / (float)(ShapeCacheHits + ShapeCacheMisses) : 0.0f; }
+        };
+
+        struct PhysicsSettings
+        {
+            float FixedTimestep = 1.0f / 60.0f; // physics (2D and 3D) is always stepped with this timestep
+            uint32_t MaxSubSteps = 4;           // steps per frame at most, the remaining time is dropped after a frame spike
+            bool Interpolate = true;            // interpolate the rendered transforms between the last two physics steps
+            PhysicsWorld3D::Capacity Capacity3D;  // changing it rebuilds the 3D physics world on the next OnRuntimeStart()
+            CollisionMatrix3D Collision3D;        // layers used by IDComponent::LayerMask, applied on the next OnRuntimeStart()
+        };
+
+    public:
+        Scene(const std::string& name);
+        ~Scene();
         
         Entity CreateEntity(UUID uuid, const std::string& name);
-        void RemoveEntity(Entity entity);
+        void RemoveEntity(Entity entity); // children are removed together with their parent
+        
+        // local transform values of the child are kept, pass an empty entity to detach the child
+        void SetParent(Entity child, Entity parent);
         
         void OnRuntimeStart();
         void OnRuntimeEnd();
         
         void OnUpdateRuntime(Timestep ts);
+        
+        // hot reload: the running scripts whose file was modified get the new functions, their data is kept.
+        // @NOTE: stats the script files, call it every now and then and not every frame
+        uint32_t ReloadChangedScripts();
         void OnRenderRuntime();
         
         void OnUpdateEditor(Timestep ts);
@@ -40,6 +84,59 @@ namespace Spectral {
         
         const size_t GetEntityCount() const { return m_EntityMap.size(); }
         const std::string& GetName() { return m_Name; }
+        const RenderStats& GetRenderStats() const { return m_RenderStats; }
+
+        const PhysicsStats& GetPhysicsStats() const { return m_PhysicsStats; }
+        const PhysicsSettings& GetPhysicsSettings() const { return m_PhysicsSettings; }
+        void SetPhysicsSettings(const PhysicsSettings& settings) { m_PhysicsSettings = settings; }
+        
+        // raycasts and overlap tests, only hit bodies between OnRuntimeStart() and OnRuntimeEnd()
+        PhysicsQuery& GetPhysicsQuery() { return m_PhysicsQuery; }
+
+        // culls and records the commands of every sprite/model, chunks of entities are processed in parallel on the JobSystem
+        // @NOTE: CPU only (no GL calls), so it can also be used headless
+        void BuildRenderQueue(const Math::Frustum& frustum, const Vector3& viewPosition);
+        const RenderQueue& GetRenderQueue() const { return m_RenderQueue; }
+        
+        // closest sprite/model hit by the ray: BVH traversal over the entity bounds, exact quad/mesh tests on the candidates only.
+        // @NOTE: uses the bounds of the last BuildRenderQueue(), returns an empty entity when nothing is hit
+        Entity PickEntity(const Ray& ray, RayCollision& collision);
+        const DynamicBVH& GetBoundsTree() const { return m_BoundsTree; }
+        
+        // world space AABB of every entity with a transform (the sprite/model bounds, a point for the others),
+        // updated incrementally with the world transforms. Used for box/sphere/frustum/ray queries of the gameplay code
+        const SpatialIndex& GetSpatialIndex() const { return m_SpatialIndex; }
+        
+    private:
+        void DetachFromParent(entt::entity child);
+        
+        void OnTransformConstruct(entt::registry& registry, entt::entity handle);
+        void OnTransformDestroy(entt::registry& registry, entt::entity handle);
+        void OnBoundsDestroy(entt::registry& registry, entt::entity handle);
+        void OnRigidBody3DDestroy(entt::registry& registry, entt::entity handle);
+        
+        void RebuildTransformOrder();
+        void PropagateTransforms(size_t begin, size_t end, std::vector<entt::entity>& moved);
+        void UpdateWorldTransforms();
+        void UpdateSpatialIndex();
+
+        void CreateBodies3D(); // batched, see OnRuntimeStart()
+        void UpdatePhysics(Timestep ts);
+        void StorePhysicsStates();                    // after every fixed step
+        void ApplyPhysicsInterpolation(float alpha); // once per frame, alpha = remaining time / fixed timestep
+
+        // one partition of the renderable entities, culled and recorded by a single job
+        struct RenderChunk
+        {
+            FrustumCuller Culler;
+            RenderQueue Queue;
+            std::vector<entt::entity> MovedBounds; // world bounds recomputed by this chunk, the BVH is updated after the jobs
+        };
+        
+        void AddMissingBounds();
+        void BuildRenderChunk(RenderChunk& chunk, const entt::entity* begin, const entt::entity* end, const Math::Frustum& frustum, const Vector3& viewPosition);
+        void UpdateBoundsTree(size_t chunkCount);
+        void RenderEntities(const Math::Frustum& frustum, bool debug);
         
     private:
         entt::registry m_Registry;
@@ -48,12 +145,56 @@ namespace Spectral {
         std::shared_ptr<RuntimeCamera> m_RuntimeCamera;
         std::string m_Name;
         
+        std::vector<std::vector<entt::entity>> m_ScriptWorkerEntities; // parallel lua scripts, grouped by worker lua state
+        std::vector<std::vector<entt::entity>> m_ScriptBatchEntities;  // lua scripts with OnUpdateAll, grouped by script type
+        
         b2World* m_PhysicsWorld = nullptr;
+        PhysicsWorld3D* m_PhysicsWorld3D = nullptr; // created on the first OnRuntimeStart() and reused by the next play sessions
+        PhysicsSettings m_PhysicsSettings;
+        PhysicsStats m_PhysicsStats;
+        PhysicsQuery m_PhysicsQuery;
+        float m_PhysicsAccumulator = 0.0f; // simulation time the physics is behind the frame time
+        
+        std::vector<entt::entity> m_BodyEntities3D;  // entity of every Jolt body, indexed by BodyID::GetIndex()
+        std::vector<entt::entity> m_MovingBodies3D;  // active during the last physics step
+        std::vector<entt::entity> m_StoppedBodies3D; // fell asleep since the last frame, written once more
+        
+        struct Body2D
+        {
+            b2Body* Body = nullptr;
+            entt::entity Entity = entt::null;
+            bool Moving = false; // awake during the last physics step
+        };
+        
+        std::vector<Body2D> m_Bodies2D;              // kinematic and dynamic bodies only, static bodies are never written back
+        std::vector<entt::entity> m_MovingBodies2D;
+        std::vector<entt::entity> m_StoppedBodies2D;
+        
+        // transforms in topological order (parents before children), each range is one root and its whole subtree
+        struct TransformRange
+        {
+            size_t Begin = 0;
+            size_t Count = 0;
+        };
+        
+        std::vector<entt::entity> m_TransformOrder;
+        std::vector<TransformRange> m_TransformRanges;
+        bool m_TransformOrderDirty = false;
+        
+        std::vector<std::vector<entt::entity>> m_MovedTransforms; // world matrix rebuilt this frame, one list per JobSystem thread
+        SpatialIndex m_SpatialIndex;
+        
+        std::vector<RenderChunk> m_RenderChunks;
+        size_t m_RenderChunkCount = 0; // chunks used by the last frame, the vector only grows
+        RenderQueue m_RenderQueue;
+        RenderStats m_RenderStats;
+        DynamicBVH m_BoundsTree; // world bounds of every sprite/model entity
         
         // allow access to private members
         friend class Entity;
         friend class SceneSerializer;
         friend class HierarchyPanel;
         friend class EditorLayer;
+        friend class PhysicsQuery;
     };
 }
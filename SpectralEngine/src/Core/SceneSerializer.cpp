@@ -136,6 +136,90 @@ namespace Spectral {
         return RigidBody2DComponent::BodyType::Static;
     }
 
+    static std::string CollisionLayerTypeToString(CollisionMatrix3D::LayerType layerType)
+    {
+        switch (layerType)
+        {
+            case CollisionMatrix3D::LayerType::Default: return "Default";
+            case CollisionMatrix3D::LayerType::Trigger: return "Trigger";
+            case CollisionMatrix3D::LayerType::Debris:  return "Debris";
+        }
+
+        // @TODO: ASSERT(false, "Unknown layer type");
+        return {};
+    }
+
+    static CollisionMatrix3D::LayerType CollisionLayerTypeFromString(const std::string& layerTypeString)
+    {
+        if (layerTypeString == "Default") return CollisionMatrix3D::LayerType::Default;
+        if (layerTypeString == "Trigger") return CollisionMatrix3D::LayerType::Trigger;
+        if (layerTypeString == "Debris")  return CollisionMatrix3D::LayerType::Debris;
+    
+        // @TODO: ASSERT(false, "Unknown layer type");
+        return CollisionMatrix3D::LayerType::Default;
+    }
+
+    static void SerializeCollisionMatrix(YAML::Emitter& out, const CollisionMatrix3D& matrix)
+    {
+        out << YAML::Key << "CollisionLayers" << YAML::Value << YAML::BeginSeq;
+        for (uint32_t i = 0; i < matrix.GetLayerCount(); i++)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << "Name" << YAML::Value << matrix.Layers[i].Name;
+            out << YAML::Key << "Type" << YAML::Value << CollisionLayerTypeToString(matrix.Layers[i].Type);
+            
+            out << YAML::Key << "CollidesWith" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+            for (uint32_t j = 0; j < matrix.GetLayerCount(); j++)
+            {
+                if (matrix.ShouldCollide(i, j)) {
+                    out << matrix.Layers[j].Name;
+                }
+            }
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+        }
+        out << YAML::EndSeq;
+    }
+
+    static CollisionMatrix3D DeserializeCollisionMatrix(const YAML::Node& layers)
+    {
+        CollisionMatrix3D matrix;
+        matrix.Layers.clear();
+        
+        // layers first, the collision lists reference them by name
+        for (auto layer : layers)
+        {
+            const std::string name = layer["Name"].as<std::string>();
+            if (matrix.AddLayer(name, CollisionLayerTypeFromString(layer["Type"].as<std::string>("Default"))) < 0) {
+                SP_LOG_WARN("Too many collision layers, {0} is ignored (max {1})", name, CollisionMatrix3D::MaxLayers);
+            }
+        }
+        
+        if (matrix.GetLayerCount() == 0) {
+            return CollisionMatrix3D();
+        }
+        
+        for (auto layer : layers)
+        {
+            const int32_t layerIndex = matrix.FindLayer(layer["Name"].as<std::string>());
+            if (layerIndex < 0 || !layer["CollidesWith"]) {
+                continue;
+            }
+            
+            for (auto other : layer["CollidesWith"])
+            {
+                const int32_t otherIndex = matrix.FindLayer(other.as<std::string>());
+                if (otherIndex < 0) {
+                    SP_LOG_WARN("Unknown collision layer {0}", other.as<std::string>());
+                    continue;
+                }
+                matrix.SetCollision(layerIndex, otherIndex, true);
+            }
+        }
+        
+        return matrix;
+    }
+
     static void SerializeEntity(YAML::Emitter& out, Entity entt)
     {
         out << YAML::BeginMap; // Object
@@ -145,6 +229,10 @@ namespace Spectral {
         out << YAML::Key << "Name" << YAML::Value << idc.Name;
         out << YAML::Key << "LayerMask" << YAML::Value << idc.LayerMask;
         
+        if (Entity parent = entt.GetParent()) {
+            out << YAML::Key << "Parent" << YAML::Value << parent.GetComponent<IDComponent>().ID;
+        }
+        
         if (entt.HasComponent<TransformComponent>())
         {
             out << YAML::Key << "TransformComponent";
@@ -279,6 +367,18 @@ namespace Spectral {
         YAML::Emitter out;
         out << YAML::BeginMap;
         out << YAML::Key << "Scene" << YAML::Value << m_Scene->m_Name;
+        
+        const Scene::PhysicsSettings& physicsSettings = m_Scene->m_PhysicsSettings;
+        out << YAML::Key << "Physics" << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "FixedTimestep" << YAML::Value << physicsSettings.FixedTimestep;
+        out << YAML::Key << "MaxSubSteps" << YAML::Value << physicsSettings.MaxSubSteps;
+        out << YAML::Key << "Interpolate" << YAML::Value << physicsSettings.Interpolate;
+        out << YAML::Key << "MaxBodies" << YAML::Value << physicsSettings.Capacity3D.MaxBodies;
+        out << YAML::Key << "MaxBodyPairs" << YAML::Value << physicsSettings.Capacity3D.MaxBodyPairs;
+        out << YAML::Key << "MaxContactConstraints" << YAML::Value << physicsSettings.Capacity3D.MaxContactConstraints;
+        SerializeCollisionMatrix(out, physicsSettings.Collision3D);
+        out << YAML::EndMap;
+        
         out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
         
         for(auto entityID : m_Scene->m_Registry.view<entt::entity>())
@@ -315,9 +415,37 @@ namespace Spectral {
             return false;
         }
         
+        // older scenes have no physics settings, the defaults are kept
+        auto physics = data["Physics"];
+        if (physics)
+        {
+            Scene::PhysicsSettings& physicsSettings = m_Scene->m_PhysicsSettings;
+            physicsSettings.FixedTimestep = physics["FixedTimestep"].as<float>(physicsSettings.FixedTimestep);
+            physicsSettings.MaxSubSteps = physics["MaxSubSteps"].as<uint32_t>(physicsSettings.MaxSubSteps);
+            physicsSettings.Interpolate = physics["Interpolate"].as<bool>(physicsSettings.Interpolate);
+            
+            PhysicsWorld3D::Capacity& capacity = physicsSettings.Capacity3D;
+            capacity.MaxBodies = physics["MaxBodies"].as<uint32_t>(capacity.MaxBodies);
+            capacity.MaxBodyPairs = physics["MaxBodyPairs"].as<uint32_t>(capacity.MaxBodyPairs);
+            capacity.MaxContactConstraints = physics["MaxContactConstraints"].as<uint32_t>(capacity.MaxContactConstraints);
+            
+            if (auto collisionLayers = physics["CollisionLayers"]) {
+                physicsSettings.Collision3D = DeserializeCollisionMatrix(collisionLayers);
+            }
+            
+            if (physicsSettings.FixedTimestep <= 0.0f) {
+                SP_LOG_WARN("Invalid physics timestep {0}, using 1/60", physicsSettings.FixedTimestep);
+                physicsSettings.FixedTimestep = 1.0f / 60.0f;
+            }
+            physicsSettings.MaxSubSteps = std::max<uint32_t>(physicsSettings.MaxSubSteps, 1);
+        }
+        
         auto entities = data["Entities"];
         if (entities)
         {
+            // parents can be serialized after their children, links are resolved once every entity exists
+            std::vector<std::pair<Entity, UUID>> parentLinks;
+            
             for (auto entity : entities)
             {
                 uint64_t uuid = entity["ID"].as<Spectral::UUID>();
@@ -327,6 +455,10 @@ namespace Spectral {
                 
                 entt.GetComponent<IDComponent>().LayerMask = entity["LayerMask"].as<uint16_t>();
                 
+                if (auto parent = entity["Parent"]) {
+                    parentLinks.push_back({entt, parent.as<Spectral::UUID>()});
+                }
+                
                 SP_LOG_INFO("Deserializing object : {0}, {1}", uuid, name);
                 
                 auto transformComponent = entity["TransformComponent"];
@@ -334,7 +466,15 @@ namespace Spectral {
                 {
                     auto& tc = entt.GetOrAddComponent<TransformComponent>();
                     tc.Translation = transformComponent["Translation"].as<Vector3>();
-                    tc.Rotation = transformComponent["Rotation"].as<Vector3>();
+                    
+                    // quaternion since the rotation is stored as one, older scenes have euler angles
+                    auto rotation = transformComponent["Rotation"];
+                    if (rotation.size() == 4) {
+                        tc.Rotation = rotation.as<Vector4>();
+                    } else {
+                        tc.SetEulerAngles(rotation.as<Vector3>());
+                    }
+                    
                     tc.Scale = transformComponent["Scale"].as<Vector3>();
                 }
                 
@@ -419,6 +559,16 @@ namespace Spectral {
                 }
                 
             }
+            
+            for (auto& [child, parentID] : parentLinks)
+            {
+                auto it = m_Scene->m_EntityMap.find(parentID);
+                if (it != m_Scene->m_EntityMap.end()) {
+                    child.SetParent({it->second, m_Scene.get()});
+                } else {
+                    SP_LOG_WARN("Deserializing object : parent ({0}) not found", (uint64_t)parentID);
+                }
+            }
         }
         return true;
     }
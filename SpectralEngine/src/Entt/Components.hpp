@@ -12,6 +12,7 @@
 #include "raymath.h"
 #include "rlgl.h"
 #include "sol.hpp"
+#include "entt.hpp"
 
 #include "Core/UUID.hpp"
 #include "Renderer/RuntimeCamera.hpp"
@@ -23,29 +24,60 @@ namespace Spectral {
     {
         UUID ID;
         std::string Name;
-        uint16_t LayerMask = 1; // used for physics 3d collision
+        uint16_t LayerMask = 1; // index of the 3D collision layer, see Scene::PhysicsSettings::Collision3D
         
         IDComponent(UUID uuid, const std::string& name)
                 : ID(uuid), Name(name) {}
     };
     
-    struct TransformComponent
+    struct TransformComponent // relative to the parent entity (see RelationshipComponent), world space for root entities
     {
-        Vector3 Translation = {0.0f, 0.0f, 0.0f};
-        Vector3 Rotation    = {0.0f, 0.0f, 0.0f};
-        Vector3 Scale       = {1.0f, 1.0f, 1.0f};
+        Vector3    Translation = {0.0f, 0.0f, 0.0f};
+        Quaternion Rotation    = {0.0f, 0.0f, 0.0f, 1.0f}; // physics and rendering work with the quaternion directly
+        Vector3    Scale       = {1.0f, 1.0f, 1.0f};
         
+        // euler angles in radians (same order as MatrixRotateZYX), only for the editor and lua
+        Vector3 GetEulerAngles() const { return QuaternionToEuler(Rotation); }
+        void SetEulerAngles(const Vector3& angles) { Rotation = QuaternionFromEuler(angles.x, angles.y, angles.z); }
         
         Matrix GetTransform() const
         {
             // calculate transformation matrix (scale * rotate * translate)
-            Matrix rotation = MatrixRotateZYX(Rotation);
+            Matrix rotation = QuaternionToMatrix(Rotation);
 
             return MatrixMultiply(MatrixMultiply(MatrixScale(Scale.x, Scale.y, Scale.z), rotation)
                                   , MatrixTranslate(Translation.x, Translation.y, Translation.z));
         }
     };
 
+    // Parent/child links, children form an intrusive doubly linked list (only added to entities that are part of a hierarchy)
+    struct RelationshipComponent
+    {
+        entt::entity Parent = entt::null;
+        entt::entity FirstChild = entt::null;
+        entt::entity PrevSibling = entt::null;
+        entt::entity NextSibling = entt::null;
+        size_t ChildrenCount = 0;
+    };
+
+    // Runtime only, added by the scene to every entity with a TransformComponent
+    struct WorldTransformComponent
+    {
+        Matrix Local = MatrixIdentity();     // TransformComponent relative to the parent
+        Matrix Transform = MatrixIdentity(); // world space, Local * parent world
+        
+        // transform the local matrix was built from, the matrix is only rebuilt when it changes
+        TransformComponent CachedTransform;
+        uint32_t CachedParentVersion = 0;
+        uint32_t Version = 0; // incremented every time the world matrix is rebuilt
+        bool Valid = false;
+        
+        // hierarchy info resolved by the scene when the hierarchy changes, used to sort the transforms
+        entt::entity Parent = entt::null;
+        entt::entity Root = entt::null;
+        uint32_t Depth = 0;
+    };
+
     struct SpriteComponent
     {
         Texture2D SpriteTexture;
@@ -60,6 +92,21 @@ namespace Spectral {
         bool      Transparency = false;
     };
 
+    // Runtime only, added by the scene to every sprite/model entity and used for frustum culling
+    struct BoundsComponent
+    {
+        BoundingBox LocalBounds = {};
+        BoundingBox WorldBounds = {};
+        
+        // state the bounds were computed from, bounds are only recomputed when it changes
+        uint32_t CachedWorldVersion = 0;
+        const Mesh* CachedMeshes = nullptr;
+        bool CachedSprite = false;
+        bool Valid = false;
+        
+        int32_t TreeProxy = -1; // leaf in the bounds BVH of the scene, used for picking
+    };
+
     // 2D Physics
 
     struct RigidBody2DComponent
@@ -127,6 +174,19 @@ namespace Spectral {
         float Density = 1.0f;
     };
 
+    // Runtime only, added to every 2D/3D rigid body by Scene::OnRuntimeStart()
+    // physics runs at a fixed rate, the TransformComponent is interpolated between the last two physics states
+    struct PhysicsInterpolationComponent
+    {
+        Vector3 PreviousTranslation = {0.0f, 0.0f, 0.0f};
+        Vector3 CurrentTranslation = {0.0f, 0.0f, 0.0f};
+        Quaternion PreviousRotation = {0.0f, 0.0f, 0.0f, 1.0f};
+        Quaternion CurrentRotation = {0.0f, 0.0f, 0.0f, 1.0f};
+        Quaternion BaseRotation = {0.0f, 0.0f, 0.0f, 1.0f}; // 2D bodies: x/y rotation of the entity, the simulated z rotation is applied on top
+
+        bool Moving = false; // body was active during the last physics step
+    };
+
     struct LightComponent // @TODO: Use with some light manager
     {
         enum class LightType { Directional = 0, Point, Spot };
@@ -155,6 +215,15 @@ namespace Spectral {
     {
         sol::table self;
         std::string ScriptPath;
+        
+        // runtime only, resolved by ScriptingEngine::OnCreate (and ReloadScript), invalid when the script has no such function
+        sol::protected_function CreateFunction;
+        sol::protected_function UpdateFunction;
+        sol::protected_function DestroyFunction;
+        sol::protected_function UpdateAllFunction; // batched update of every entity running the script, replaces OnUpdate
+        
+        int32_t Worker = -1; // runtime only, worker lua state of a parallel script (-1 = main state)
+        int32_t Batch = -1;  // runtime only, script type of a script with OnUpdateAll (-1 = updated per entity)
     };
     
     struct AnimationComponent
@@ -67,6 +67,22 @@ namespace Spectral {
             return false;
         }
 
+        // pass an empty entity to detach from the current parent
+        void SetParent(Entity parent)
+        {
+            m_SceneContext->SetParent(*this, parent);
+        }
+        
+        Entity GetParent()
+        {
+            const auto* relationship = m_SceneContext->m_Registry.try_get<RelationshipComponent>(m_EnttHandle);
+            
+            if (!relationship || relationship->Parent == entt::null) {
+                return {};
+            }
+            return { relationship->Parent, m_SceneContext };
+        }
+
         operator entt::entity() const { return m_EnttHandle; }
         operator bool() const { return m_EnttHandle != entt::null; }
         bool operator==(const Entity& other) const
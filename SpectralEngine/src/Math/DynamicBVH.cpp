@@ -0,0 +1,362 @@
+//
+//  DynamicBVH.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "DynamicBVH.hpp"
+
+#include "Math.hpp"
+
+namespace Spectral {
+
+    namespace {
+        // leaves are enlarged by this fraction of their size (and at least s_MinMargin), so small moves don't touch the tree
+        constexpr float s_MarginFactor = 0.1f;
+        constexpr float s_MinMargin = 0.01f;
+
+        float SurfaceArea(const BoundingBox& box)
+        {
+            const float dx = box.max.x - box.min.x;
+            const float dy = box.max.y - box.min.y;
+            const float dz = box.max.z - box.min.z;
+            return 2.0f * (dx * dy + dy * dz + dz * dx);
+        }
+
+        bool Contains(const BoundingBox& outer, const BoundingBox& inner)
+        {
+            return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+                && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+        }
+
+        BoundingBox Fatten(const BoundingBox& box)
+        {
+            const Vector3 margin = {
+                std::max((box.max.x - box.min.x) * s_MarginFactor, s_MinMargin),
+                std::max((box.max.y - box.min.y) * s_MarginFactor, s_MinMargin),
+                std::max((box.max.z - box.min.z) * s_MarginFactor, s_MinMargin)
+            };
+
+            return (BoundingBox){
+                {box.min.x - margin.x, box.min.y - margin.y, box.min.z - margin.z},
+                {box.max.x + margin.x, box.max.y + margin.y, box.max.z + margin.z}
+            };
+        }
+    }
+
+    int32_t DynamicBVH::AllocateNode()
+    {
+        if (m_FreeList == NullNode)
+        {
+            m_Nodes.emplace_back();
+            return (int32_t)m_Nodes.size() - 1;
+        }
+
+        const int32_t node = m_FreeList;
+        m_FreeList = m_Nodes[node].Parent;
+        m_Nodes[node] = Node();
+        return node;
+    }
+
+    void DynamicBVH::FreeNode(int32_t node)
+    {
+        m_Nodes[node].Parent = m_FreeList;
+        m_Nodes[node].Height = -1;
+        m_Nodes[node].Entity = entt::null;
+        m_FreeList = node;
+    }
+
+    int32_t DynamicBVH::Insert(entt::entity entity, const BoundingBox& bounds)
+    {
+        const int32_t leaf = AllocateNode();
+        m_Nodes[leaf].Box = Fatten(bounds);
+        m_Nodes[leaf].Entity = entity;
+        m_Nodes[leaf].Height = 0;
+
+        InsertLeaf(leaf);
+        m_LeafCount++;
+        return leaf;
+    }
+
+    void DynamicBVH::Remove(int32_t proxy)
+    {
+        SP_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf(), "DynamicBVH::Remove invalid proxy");
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        m_LeafCount--;
+    }
+
+    bool DynamicBVH::Move(int32_t proxy, const BoundingBox& bounds)
+    {
+        SP_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf(), "DynamicBVH::Move invalid proxy");
+
+        if (Contains(m_Nodes[proxy].Box, bounds)) {
+            return false;
+        }
+
+        RemoveLeaf(proxy);
+        m_Nodes[proxy].Box = Fatten(bounds);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicBVH::Clear()
+    {
+        m_Nodes.clear();
+        m_Root = NullNode;
+        m_FreeList = NullNode;
+        m_LeafCount = 0;
+    }
+
+    void DynamicBVH::InsertLeaf(int32_t leaf)
+    {
+        if (m_Root == NullNode)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].Parent = NullNode;
+            return;
+        }
+
+        // find the best sibling, descending while it is cheaper than pairing with the current node (surface area heuristic)
+        const BoundingBox leafBox = m_Nodes[leaf].Box;
+        int32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf())
+        {
+            const Node& node = m_Nodes[index];
+
+            const float area = SurfaceArea(node.Box);
+            const float combinedArea = SurfaceArea(Math::MergeBoundingBoxes(node.Box, leafBox));
+
+            // cost of creating a new parent for this node and the new leaf
+            const float cost = 2.0f * combinedArea;
+
+            // minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                const float childCombinedArea = SurfaceArea(Math::MergeBoundingBoxes(m_Nodes[child].Box, leafBox));
+                return m_Nodes[child].IsLeaf() ? childCombinedArea + inheritanceCost
+                                               : childCombinedArea - SurfaceArea(m_Nodes[child].Box) + inheritanceCost;
+            };
+
+            const float cost1 = descendCost(node.Child1);
+            const float cost2 = descendCost(node.Child2);
+
+            if (cost < cost1 && cost < cost2) {
+                break;
+            }
+
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        const int32_t sibling = index;
+
+        // new parent for the sibling and the leaf
+        const int32_t oldParent = m_Nodes[sibling].Parent;
+        const int32_t newParent = AllocateNode();
+        m_Nodes[newParent].Parent = oldParent;
+        m_Nodes[newParent].Box = Math::MergeBoundingBoxes(leafBox, m_Nodes[sibling].Box);
+        m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+        m_Nodes[newParent].Child1 = sibling;
+        m_Nodes[newParent].Child2 = leaf;
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        if (oldParent == NullNode)
+        {
+            m_Root = newParent;
+        }
+        else if (m_Nodes[oldParent].Child1 == sibling)
+        {
+            m_Nodes[oldParent].Child1 = newParent;
+        }
+        else
+        {
+            m_Nodes[oldParent].Child2 = newParent;
+        }
+
+        // refit and rebalance the ancestors
+        index = m_Nodes[leaf].Parent;
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+            node.Box = Math::MergeBoundingBoxes(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+
+            index = node.Parent;
+        }
+    }
+
+    void DynamicBVH::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = NullNode;
+            return;
+        }
+
+        // the sibling takes the place of the parent
+        const int32_t parent = m_Nodes[leaf].Parent;
+        const int32_t grandParent = m_Nodes[parent].Parent;
+        const int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        if (grandParent == NullNode)
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].Parent = NullNode;
+            FreeNode(parent);
+            return;
+        }
+
+        if (m_Nodes[grandParent].Child1 == parent) {
+            m_Nodes[grandParent].Child1 = sibling;
+        } else {
+            m_Nodes[grandParent].Child2 = sibling;
+        }
+        m_Nodes[sibling].Parent = grandParent;
+        FreeNode(parent);
+
+        // refit and rebalance the ancestors
+        int32_t index = grandParent;
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = m_Nodes[index];
+            node.Box = Math::MergeBoundingBoxes(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+            node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+
+            index = node.Parent;
+        }
+    }
+
+    // rotates the subtree of A when its children heights differ by more than one, returns the new root of the subtree
+    int32_t DynamicBVH::Balance(int32_t iA)
+    {
+        Node& A = m_Nodes[iA];
+        if (A.IsLeaf() || A.Height < 2) {
+            return iA;
+        }
+
+        const int32_t iB = A.Child1;
+        const int32_t iC = A.Child2;
+        Node& B = m_Nodes[iB];
+        Node& C = m_Nodes[iC];
+
+        const int32_t balance = C.Height - B.Height;
+
+        // rotate C up
+        if (balance > 1)
+        {
+            const int32_t iF = C.Child1;
+            const int32_t iG = C.Child2;
+            Node& F = m_Nodes[iF];
+            Node& G = m_Nodes[iG];
+
+            // swap A and C
+            C.Child1 = iA;
+            C.Parent = A.Parent;
+            A.Parent = iC;
+
+            // A's old parent should point to C
+            if (C.Parent != NullNode)
+            {
+                if (m_Nodes[C.Parent].Child1 == iA) {
+                    m_Nodes[C.Parent].Child1 = iC;
+                } else {
+                    m_Nodes[C.Parent].Child2 = iC;
+                }
+            }
+            else
+            {
+                m_Root = iC;
+            }
+
+            // rotate
+            if (F.Height > G.Height)
+            {
+                C.Child2 = iF;
+                A.Child2 = iG;
+                G.Parent = iA;
+                A.Box = Math::MergeBoundingBoxes(B.Box, G.Box);
+                C.Box = Math::MergeBoundingBoxes(A.Box, F.Box);
+
+                A.Height = 1 + std::max(B.Height, G.Height);
+                C.Height = 1 + std::max(A.Height, F.Height);
+            }
+            else
+            {
+                C.Child2 = iG;
+                A.Child2 = iF;
+                F.Parent = iA;
+                A.Box = Math::MergeBoundingBoxes(B.Box, F.Box);
+                C.Box = Math::MergeBoundingBoxes(A.Box, G.Box);
+
+                A.Height = 1 + std::max(B.Height, F.Height);
+                C.Height = 1 + std::max(A.Height, G.Height);
+            }
+
+            return iC;
+        }
+
+        // rotate B up
+        if (balance < -1)
+        {
+            const int32_t iD = B.Child1;
+            const int32_t iE = B.Child2;
+            Node& D = m_Nodes[iD];
+            Node& E = m_Nodes[iE];
+
+            // swap A and B
+            B.Child1 = iA;
+            B.Parent = A.Parent;
+            A.Parent = iB;
+
+            // A's old parent should point to B
+            if (B.Parent != NullNode)
+            {
+                if (m_Nodes[B.Parent].Child1 == iA) {
+                    m_Nodes[B.Parent].Child1 = iB;
+                } else {
+                    m_Nodes[B.Parent].Child2 = iB;
+                }
+            }
+            else
+            {
+                m_Root = iB;
+            }
+
+            // rotate
+            if (D.Height > E.Height)
+            {
+                B.Child2 = iD;
+                A.Child1 = iE;
+                E.Parent = iA;
+                A.Box = Math::MergeBoundingBoxes(C.Box, E.Box);
+                B.Box = Math::MergeBoundingBoxes(A.Box, D.Box);
+
+                A.Height = 1 + std::max(C.Height, E.Height);
+                B.Height = 1 + std::max(A.Height, D.Height);
+            }
+            else
+            {
+                B.Child2 = iE;
+                A.Child1 = iD;
+                D.Parent = iA;
+                A.Box = Math::MergeBoundingBoxes(C.Box, D.Box);
+                B.Box = Math::MergeBoundingBoxes(A.Box, E.Box);
+
+                A.Height = 1 + std::max(C.Height, D.Height);
+                B.Height = 1 + std::max(A.Height, E.Height);
+            }
+
+            return iB;
+        }
+
+        return iA;
+    }
+}
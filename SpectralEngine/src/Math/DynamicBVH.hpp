@@ -0,0 +1,172 @@
+//
+//  DynamicBVH.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+#include "entt.hpp"
+
+#include "Core/Assert.hpp"
+#include "Math/Math.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Spectral {
+
+    // Bounding volume hierarchy over entity AABBs that is updated incrementally (same idea as the box2d dynamic tree).
+    // Leaves store a fattened box, moving an entity only touches the tree once its bounds leave the fat box: the leaf is then
+    // removed and reinserted, which refits and rebalances the ancestors on the way up. Not thread safe, queries are const.
+    class DynamicBVH
+    {
+    public:
+        static constexpr int32_t NullNode = -1;
+
+    public:
+        // returns the proxy (leaf) of the entity, keep it to move or remove the entity later
+        int32_t Insert(entt::entity entity, const BoundingBox& bounds);
+        void Remove(int32_t proxy);
+
+        // returns true when the leaf had to be reinserted
+        bool Move(int32_t proxy, const BoundingBox& bounds);
+
+        void Clear();
+
+        entt::entity GetEntity(int32_t proxy) const { return m_Nodes[proxy].Entity; }
+        const BoundingBox& GetFatBounds(int32_t proxy) const { return m_Nodes[proxy].Box; }
+        size_t GetLeafCount() const { return m_LeafCount; }
+        int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+        // visits the leaves whose fat box is hit by the ray closer than maxDistance, nearest boxes are visited first.
+        // callback(entity, boxDistance) returns the new max distance, return the closest exact hit so far to skip farther boxes
+        template <typename Func>
+        void QueryRay(const Ray& ray, float maxDistance, Func&& callback) const;
+
+        // callback(entity) for every leaf whose fat box overlaps the box
+        template <typename Func>
+        void QueryBox(const BoundingBox& box, Func&& callback) const;
+
+    private:
+        struct Node
+        {
+            BoundingBox Box = {};
+            int32_t Parent = NullNode; // next free node while the node is unused
+            int32_t Child1 = NullNode;
+            int32_t Child2 = NullNode;
+            int32_t Height = 0;        // leaves are 0, -1 for free nodes
+            entt::entity Entity = entt::null;
+
+            bool IsLeaf() const { return Child1 == NullNode; }
+        };
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t node);
+
+    private:
+        std::vector<Node> m_Nodes;
+        int32_t m_Root = NullNode;
+        int32_t m_FreeList = NullNode;
+        size_t m_LeafCount = 0;
+    };
+
+    template <typename Func>
+    void DynamicBVH::QueryRay(const Ray& ray, float maxDistance, Func&& callback) const
+    {
+        if (m_Root == NullNode) {
+            return;
+        }
+
+        const Vector3 inverseDirection = {
+            ray.direction.x != 0.0f ? 1.0f / ray.direction.x : FLT_MAX,
+            ray.direction.y != 0.0f ? 1.0f / ray.direction.y : FLT_MAX,
+            ray.direction.z != 0.0f ? 1.0f / ray.direction.z : FLT_MAX
+        };
+
+        // (node, distance) pairs, the nearer child is pushed last so it is popped first
+        struct Entry { int32_t Node; float Distance; };
+        Entry stack[64];
+        int32_t count = 0;
+
+        // strict compares: misses are FLT_MAX, and a box at exactly maxDistance can't hold a closer hit
+        const float rootDistance = Math::RayBoxDistance(ray.position, inverseDirection, m_Nodes[m_Root].Box);
+        if (rootDistance >= maxDistance) {
+            return;
+        }
+        stack[count++] = {m_Root, rootDistance};
+
+        while (count > 0)
+        {
+            const Entry entry = stack[--count];
+            if (entry.Distance >= maxDistance) {
+                continue; // clipped by a closer hit after it was pushed
+            }
+
+            const Node& node = m_Nodes[entry.Node];
+            if (node.IsLeaf())
+            {
+                maxDistance = std::min(maxDistance, (float)callback(node.Entity, entry.Distance));
+                continue;
+            }
+
+            float distance1 = Math::RayBoxDistance(ray.position, inverseDirection, m_Nodes[node.Child1].Box);
+            float distance2 = Math::RayBoxDistance(ray.position, inverseDirection, m_Nodes[node.Child2].Box);
+            int32_t child1 = node.Child1;
+            int32_t child2 = node.Child2;
+
+            if (distance2 > distance1)
+            {
+                std::swap(distance1, distance2);
+                std::swap(child1, child2);
+            }
+
+            // the tree is kept balanced, its height stays far below the stack size
+            SP_ASSERT(count + 2 <= 64, "DynamicBVH stack overflow");
+            if (distance1 < maxDistance) {
+                stack[count++] = {child1, distance1};
+            }
+            if (distance2 < maxDistance) {
+                stack[count++] = {child2, distance2};
+            }
+        }
+    }
+
+    template <typename Func>
+    void DynamicBVH::QueryBox(const BoundingBox& box, Func&& callback) const
+    {
+        if (m_Root == NullNode) {
+            return;
+        }
+
+        int32_t stack[64];
+        int32_t count = 0;
+        stack[count++] = m_Root;
+
+        while (count > 0)
+        {
+            const Node& node = m_Nodes[stack[--count]];
+            if (!CheckCollisionBoxes(node.Box, box)) {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                callback(node.Entity);
+            }
+            else
+            {
+                SP_ASSERT(count + 2 <= 64, "DynamicBVH stack overflow");
+                stack[count++] = node.Child1;
+                stack[count++] = node.Child2;
+            }
+        }
+    }
+}
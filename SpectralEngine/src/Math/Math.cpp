@@ -9,6 +9,9 @@
 
 #include "raymath.h"
 
+#include <algorithm>
+#include <cfloat>
+
 namespace Spectral::Math {
 
     Matrix3 InvertMatrix(Matrix3 mat)
@@ -67,6 +70,24 @@ namespace Spectral::Math {
         return result;
     }
 
+    void DecomposeTransform(Matrix transform, Vector3* translation, Quaternion* rotation, Vector3* scale)
+    {
+        // the first three columns are the scaled axes, the last one the translation
+        *scale = {
+            Vector3Length({transform.m0, transform.m1, transform.m2}),
+            Vector3Length({transform.m4, transform.m5, transform.m6}),
+            Vector3Length({transform.m8, transform.m9, transform.m10})
+        };
+
+        Matrix rotationMatrix = MatrixIdentity();
+        rotationMatrix.m0 = transform.m0 / scale->x; rotationMatrix.m1 = transform.m1 / scale->x; rotationMatrix.m2 = transform.m2 / scale->x;
+        rotationMatrix.m4 = transform.m4 / scale->y; rotationMatrix.m5 = transform.m5 / scale->y; rotationMatrix.m6 = transform.m6 / scale->y;
+        rotationMatrix.m8 = transform.m8 / scale->z; rotationMatrix.m9 = transform.m9 / scale->z; rotationMatrix.m10 = transform.m10 / scale->z;
+
+        *translation = {transform.m12, transform.m13, transform.m14};
+        *rotation = QuaternionNormalize(QuaternionFromMatrix(rotationMatrix));
+    }
+
     void NormalizePlane(Vector4* plane)
     {
         if (!plane) {
@@ -158,5 +179,66 @@ namespace Spectral::Math {
         
         return Vector3Transform(v, invMat);
     }
-    
+
+    BoundingBox GetMeshesBoundingBox(const Model& model)
+    {
+        BoundingBox bounds = { 0 };
+        
+        if (model.meshCount <= 0 || !model.meshes) {
+            return bounds;
+        }
+        
+        bounds = GetMeshBoundingBox(model.meshes[0]);
+        
+        for (int i = 1; i < model.meshCount; i++) {
+            bounds = MergeBoundingBoxes(bounds, GetMeshBoundingBox(model.meshes[i]));
+        }
+        
+        return bounds;
+    }
+
+    BoundingBox TransformBoundingBox(BoundingBox box, Matrix transform)
+    {
+        // transform the center and project the extents onto the world axes (Arvo, Graphics Gems 1990)
+        const Vector3 center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+        const Vector3 extent = Vector3Scale(Vector3Subtract(box.max, box.min), 0.5f);
+        
+        const Vector3 worldCenter = ::Vector3Transform(center, transform);
+        const Vector3 worldExtent = {
+            fabsf(transform.m0) * extent.x + fabsf(transform.m4) * extent.y + fabsf(transform.m8) * extent.z,
+            fabsf(transform.m1) * extent.x + fabsf(transform.m5) * extent.y + fabsf(transform.m9) * extent.z,
+            fabsf(transform.m2) * extent.x + fabsf(transform.m6) * extent.y + fabsf(transform.m10) * extent.z
+        };
+        
+        return (BoundingBox){ Vector3Subtract(worldCenter, worldExtent), Vector3Add(worldCenter, worldExtent) };
+    }
+
+    BoundingBox MergeBoundingBoxes(BoundingBox a, BoundingBox b)
+    {
+        return (BoundingBox){ Vector3Min(a.min, b.min), Vector3Max(a.max, b.max) };
+    }
+
+    float RayBoxDistance(const Vector3& origin, const Vector3& inverseDirection, const BoundingBox& box)
+    {
+        // slab test
+        float t1 = (box.min.x - origin.x) * inverseDirection.x;
+        float t2 = (box.max.x - origin.x) * inverseDirection.x;
+        float tMin = std::min(t1, t2);
+        float tMax = std::max(t1, t2);
+
+        t1 = (box.min.y - origin.y) * inverseDirection.y;
+        t2 = (box.max.y - origin.y) * inverseDirection.y;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        t1 = (box.min.z - origin.z) * inverseDirection.z;
+        t2 = (box.max.z - origin.z) * inverseDirection.z;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+
+        if (tMax < 0.0f || tMin > tMax) {
+            return FLT_MAX;
+        }
+        return std::max(tMin, 0.0f);
+    }
 }
@@ -22,6 +22,9 @@ namespace Spectral::Math {
     Matrix3 InvertMatrix(Matrix3 mat);
     Vector3 Vector3Transform(Vector3 v, Matrix3 mat);
 
+    // Matrix functions
+    void DecomposeTransform(Matrix transform, Vector3* translation, Quaternion* rotation, Vector3* scale); // scale * rotation * translation, no shear
+
     // Frustum functions
     // https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
     void NormalizePlane(Vector4* plane);
@@ -29,4 +32,12 @@ namespace Spectral::Math {
 
     
     Vector3 Intersection(Vector4 plane1, Vector4 plane2, Vector4 plane3);
+
+    // Bounding box functions
+    BoundingBox GetMeshesBoundingBox(const Model& model); // local space bounds of all meshes, model.transform is ignored
+    BoundingBox TransformBoundingBox(BoundingBox box, Matrix transform); // world space AABB enclosing the transformed box
+    BoundingBox MergeBoundingBoxes(BoundingBox a, BoundingBox b);
+
+    // Ray functions
+    float RayBoxDistance(const Vector3& origin, const Vector3& inverseDirection, const BoundingBox& box); // slab test, FLT_MAX when missed (0 when the origin is inside)
 }
@@ -0,0 +1,247 @@
+//
+//  SpatialIndex.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "SpatialIndex.hpp"
+
+#include "Core/Assert.hpp"
+
+#include "raymath.h"
+
+namespace Spectral {
+
+    SpatialIndex::SpatialIndex(float cellSize)
+    {
+        SP_ASSERT(cellSize > 0.0f, "SpatialIndex cell size has to be positive");
+        m_CellSize = cellSize;
+        m_InverseCellSize = 1.0f / cellSize;
+    }
+
+    void SpatialIndex::Insert(entt::entity entity, const BoundingBox& bounds)
+    {
+        const uint32_t index = entt::to_entity(entity);
+        if (index >= m_Slots.size()) {
+            m_Slots.resize(std::max<size_t>(index + 1, m_Slots.size() * 2));
+        }
+
+        SP_ASSERT(m_Slots[index].Entity == entt::null, "Entity is already in the SpatialIndex");
+
+        const uint32_t cell = IsOversized(bounds) ? OversizedCell : FindOrCreateCell(GetKey(bounds));
+        Append(cell, entity, bounds);
+        m_Count++;
+    }
+
+    void SpatialIndex::Update(entt::entity entity, const BoundingBox& bounds)
+    {
+        const uint32_t index = entt::to_entity(entity);
+        if (index >= m_Slots.size() || m_Slots[index].Entity != entity)
+        {
+            // a recycled entity index still in the index means the old entity was never removed
+            if (index < m_Slots.size() && m_Slots[index].Entity != entt::null) {
+                Remove(m_Slots[index].Entity);
+            }
+            Insert(entity, bounds);
+            return;
+        }
+
+        Slot& slot = m_Slots[index];
+        const bool oversized = IsOversized(bounds);
+
+        // still in the same cell: overwrite the box in place
+        if ((oversized && slot.Cell == OversizedCell) || (!oversized && slot.Cell != OversizedCell && m_Cells[slot.Cell].Key == GetKey(bounds)))
+        {
+            Cell& cell = GetCell(slot.Cell);
+            cell.Boxes[slot.Index] = bounds;
+            cell.Bounds = Math::MergeBoundingBoxes(cell.Bounds, bounds);
+
+            if (!oversized) {
+                m_MaxHalfExtent = std::max(m_MaxHalfExtent, 0.5f * std::max({bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z}));
+            }
+            return;
+        }
+
+        Erase(slot);
+        Append(oversized ? OversizedCell : FindOrCreateCell(GetKey(bounds)), entity, bounds);
+    }
+
+    void SpatialIndex::Remove(entt::entity entity)
+    {
+        const uint32_t index = entt::to_entity(entity);
+        if (index >= m_Slots.size() || m_Slots[index].Entity != entity) {
+            return;
+        }
+
+        Erase(m_Slots[index]);
+        m_Slots[index] = {};
+        m_Count--;
+    }
+
+    bool SpatialIndex::Contains(entt::entity entity) const
+    {
+        const uint32_t index = entt::to_entity(entity);
+        return index < m_Slots.size() && m_Slots[index].Entity == entity;
+    }
+
+    void SpatialIndex::SetCellSize(float cellSize)
+    {
+        SP_ASSERT(cellSize > 0.0f, "SpatialIndex cell size has to be positive");
+        if (cellSize == m_CellSize) {
+            return;
+        }
+
+        // collect everything, then insert it again with the new cell size
+        std::vector<entt::entity> entities;
+        std::vector<BoundingBox> boxes;
+        entities.reserve(m_Count);
+        boxes.reserve(m_Count);
+
+        for (const Cell& cell : m_Cells)
+        {
+            entities.insert(entities.end(), cell.Entities.begin(), cell.Entities.end());
+            boxes.insert(boxes.end(), cell.Boxes.begin(), cell.Boxes.end());
+        }
+        entities.insert(entities.end(), m_Oversized.Entities.begin(), m_Oversized.Entities.end());
+        boxes.insert(boxes.end(), m_Oversized.Boxes.begin(), m_Oversized.Boxes.end());
+
+        Clear();
+        m_CellSize = cellSize;
+        m_InverseCellSize = 1.0f / cellSize;
+
+        for (size_t i = 0; i < entities.size(); i++) {
+            Insert(entities[i], boxes[i]);
+        }
+    }
+
+    void SpatialIndex::Clear()
+    {
+        m_Cells.clear();
+        m_FreeCells.clear();
+        m_CellMap.clear();
+        m_Oversized = {};
+        m_Slots.clear();
+        m_Count = 0;
+        m_MaxHalfExtent = 0.0f;
+    }
+
+    void SpatialIndex::Reserve(size_t entityCount)
+    {
+        m_Slots.reserve(entityCount);
+    }
+
+    int32_t SpatialIndex::ToCellCoordinate(float value) const
+    {
+        // clamped so the coordinate fits into its 21 bits of the key, far away cells simply share the border cells
+        const float cell = std::floor(value * m_InverseCellSize);
+        return (int32_t)Clamp(cell, (float)-MaxCellCoordinate, (float)MaxCellCoordinate);
+    }
+
+    uint64_t SpatialIndex::MakeKey(int32_t x, int32_t y, int32_t z) const
+    {
+        constexpr uint64_t mask = (1ull << 21) - 1;
+        return (((uint64_t)(x + MaxCellCoordinate) & mask) << 42) | (((uint64_t)(y + MaxCellCoordinate) & mask) << 21) | ((uint64_t)(z + MaxCellCoordinate) & mask);
+    }
+
+    bool SpatialIndex::IsOversized(const BoundingBox& bounds) const
+    {
+        const float maxSize = m_CellSize * MaxCellsPerObject;
+        return bounds.max.x - bounds.min.x > maxSize || bounds.max.y - bounds.min.y > maxSize || bounds.max.z - bounds.min.z > maxSize;
+    }
+
+    uint64_t SpatialIndex::GetKey(const BoundingBox& bounds) const
+    {
+        return MakeKey(ToCellCoordinate(0.5f * (bounds.min.x + bounds.max.x)),
+                       ToCellCoordinate(0.5f * (bounds.min.y + bounds.max.y)),
+                       ToCellCoordinate(0.5f * (bounds.min.z + bounds.max.z)));
+    }
+
+    uint32_t SpatialIndex::FindOrCreateCell(uint64_t key)
+    {
+        const auto it = m_CellMap.find(key);
+        if (it != m_CellMap.end()) {
+            return it->second;
+        }
+
+        uint32_t cell;
+        if (!m_FreeCells.empty())
+        {
+            cell = m_FreeCells.back();
+            m_FreeCells.pop_back();
+        }
+        else
+        {
+            cell = (uint32_t)m_Cells.size();
+            m_Cells.emplace_back();
+        }
+
+        m_Cells[cell].Key = key;
+        m_CellMap.emplace(key, cell);
+        return cell;
+    }
+
+    void SpatialIndex::Append(uint32_t cellIndex, entt::entity entity, const BoundingBox& bounds)
+    {
+        Cell& cell = GetCell(cellIndex);
+
+        cell.Bounds = cell.Entities.empty() ? bounds : Math::MergeBoundingBoxes(cell.Bounds, bounds);
+        m_Slots[entt::to_entity(entity)] = {entity, cellIndex, (uint32_t)cell.Entities.size()};
+        cell.Entities.push_back(entity);
+        cell.Boxes.push_back(bounds);
+
+        if (cellIndex != OversizedCell) {
+            m_MaxHalfExtent = std::max(m_MaxHalfExtent, 0.5f * std::max({bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z}));
+        }
+    }
+
+    void SpatialIndex::Erase(const Slot& slot)
+    {
+        Cell& cell = GetCell(slot.Cell);
+
+        // swap remove, the last entity of the cell takes the place of the removed one
+        const uint32_t last = (uint32_t)cell.Entities.size() - 1;
+        if (slot.Index != last)
+        {
+            cell.Entities[slot.Index] = cell.Entities[last];
+            cell.Boxes[slot.Index] = cell.Boxes[last];
+            m_Slots[entt::to_entity(cell.Entities[slot.Index])].Index = slot.Index;
+        }
+        cell.Entities.pop_back();
+        cell.Boxes.pop_back();
+
+        // empty cells leave the map (so the queries skip them) and are reused, their vectors keep their capacity
+        if (cell.Entities.empty() && slot.Cell != OversizedCell)
+        {
+            m_CellMap.erase(cell.Key);
+            m_FreeCells.push_back(slot.Cell);
+        }
+    }
+
+    bool SpatialIndex::BoxOverlapsFrustum(const Math::Frustum& frustum, const BoundingBox& box)
+    {
+        const Vector3 center = {0.5f * (box.min.x + box.max.x), 0.5f * (box.min.y + box.max.y), 0.5f * (box.min.z + box.max.z)};
+        const Vector3 extent = {0.5f * (box.max.x - box.min.x), 0.5f * (box.max.y - box.min.y), 0.5f * (box.max.z - box.min.z)};
+
+        // same plane test as the FrustumCuller: signed distance of the center plus the projected radius of the box
+        for (const Vector4& plane : frustum.Planes)
+        {
+            const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float radius = fabsf(plane.x) * extent.x + fabsf(plane.y) * extent.y + fabsf(plane.z) * extent.z;
+
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SpatialIndex::BoxOverlapsSphere(const BoundingBox& box, const Vector3& center, float radius)
+    {
+        // squared distance from the center to the closest point of the box
+        const float dx = std::max({box.min.x - center.x, 0.0f, center.x - box.max.x});
+        const float dy = std::max({box.min.y - center.y, 0.0f, center.y - box.max.y});
+        const float dz = std::max({box.min.z - center.z, 0.0f, center.z - box.max.z});
+        return dx * dx + dy * dy + dz * dz <= radius * radius;
+    }
+}
@@ -0,0 +1,261 @@
+//
+//  SpatialIndex.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+#include "entt.hpp"
+
+#include "Math/Math.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace Spectral {
+
+    // Loose hashed grid over entity AABBs, used by gameplay queries (who is near, what is in this box/frustum/ray).
+    // An entity lives in the cell of its box center, so updates are O(1): the box is overwritten in place while the center
+    // stays in the same cell, otherwise it is swap removed and appended to the new cell. Cells are only created where
+    // entities are (hashed), queries widen their range by the largest half extent seen. Boxes larger than a few cells
+    // go to a separate list that every query scans. Not thread safe, queries are const.
+    class SpatialIndex
+    {
+    public:
+        static constexpr float DefaultCellSize = 16.0f;
+        static constexpr float MaxCellsPerObject = 4.0f; // boxes wider than this (in cells) are stored in the oversized list
+
+    public:
+        SpatialIndex(float cellSize = DefaultCellSize);
+
+        // Update() inserts entities that are not in the index yet
+        void Insert(entt::entity entity, const BoundingBox& bounds);
+        void Update(entt::entity entity, const BoundingBox& bounds);
+        void Remove(entt::entity entity);
+        bool Contains(entt::entity entity) const;
+
+        // @NOTE: changing the cell size rebuilds the whole index
+        void SetCellSize(float cellSize);
+        float GetCellSize() const { return m_CellSize; }
+
+        void Clear();
+        void Reserve(size_t entityCount);
+
+        size_t GetCount() const { return m_Count; }
+        size_t GetCellCount() const { return m_CellMap.size(); }
+        size_t GetOversizedCount() const { return m_Oversized.Entities.size(); }
+
+        // callback(entity, bounds) for every entity whose box overlaps the box/sphere/frustum
+        template <typename Func>
+        void QueryBox(const BoundingBox& box, Func&& callback) const;
+        template <typename Func>
+        void QuerySphere(const Vector3& center, float radius, Func&& callback) const;
+        template <typename Func>
+        void QueryFrustum(const Math::Frustum& frustum, Func&& callback) const;
+
+        // callback(entity, distance) for every entity whose box is hit closer than maxDistance (0 when the origin is inside).
+        // @NOTE: hits are not sorted, keep the smallest distance for the closest one
+        template <typename Func>
+        void QueryRay(const Ray& ray, float maxDistance, Func&& callback) const;
+
+    private:
+        static constexpr uint32_t OversizedCell = UINT32_MAX;
+        static constexpr int32_t MaxCellCoordinate = (1 << 20) - 1; // 21 bits per axis in the cell key
+
+        struct Cell
+        {
+            uint64_t Key = 0;
+            BoundingBox Bounds = {}; // loose, grows with every insert/update and is reset once the cell is empty
+            std::vector<entt::entity> Entities;
+            std::vector<BoundingBox> Boxes;
+        };
+
+        // where an entity is stored, indexed by the entity index (entt::to_entity)
+        struct Slot
+        {
+            entt::entity Entity = entt::null;
+            uint32_t Cell = 0;
+            uint32_t Index = 0;
+        };
+
+        int32_t ToCellCoordinate(float value) const;
+        uint64_t MakeKey(int32_t x, int32_t y, int32_t z) const;
+        bool IsOversized(const BoundingBox& bounds) const;
+        uint64_t GetKey(const BoundingBox& bounds) const;
+
+        Cell& GetCell(uint32_t cell) { return cell == OversizedCell ? m_Oversized : m_Cells[cell]; }
+        uint32_t FindOrCreateCell(uint64_t key);
+        void Append(uint32_t cell, entt::entity entity, const BoundingBox& bounds);
+        void Erase(const Slot& slot);
+
+        // calls func(cell) for every cell that may hold a box overlapping area (the oversized list excluded)
+        template <typename Func>
+        void ForEachCell(const BoundingBox& area, Func&& func) const;
+
+        static bool BoxOverlapsFrustum(const Math::Frustum& frustum, const BoundingBox& box);
+        static bool BoxOverlapsSphere(const BoundingBox& box, const Vector3& center, float radius);
+
+    private:
+        float m_CellSize = DefaultCellSize;
+        float m_InverseCellSize = 1.0f / DefaultCellSize;
+        float m_MaxHalfExtent = 0.0f; // largest half extent of the boxes in the cells, only grows until Clear()
+
+        std::vector<Cell> m_Cells;
+        std::vector<uint32_t> m_FreeCells; // empty cells, reused before new ones are created
+        std::unordered_map<uint64_t, uint32_t> m_CellMap; // key -> index into m_Cells, non empty cells only
+        Cell m_Oversized;
+
+        std::vector<Slot> m_Slots;
+        size_t m_Count = 0;
+    };
+
+    template <typename Func>
+    void SpatialIndex::ForEachCell(const BoundingBox& area, Func&& func) const
+    {
+        if (m_CellMap.empty()) {
+            return;
+        }
+
+        // entities are stored by their center, so a box reaching into the area can sit up to m_MaxHalfExtent outside of it
+        const int32_t minX = ToCellCoordinate(area.min.x - m_MaxHalfExtent), maxX = ToCellCoordinate(area.max.x + m_MaxHalfExtent);
+        const int32_t minY = ToCellCoordinate(area.min.y - m_MaxHalfExtent), maxY = ToCellCoordinate(area.max.y + m_MaxHalfExtent);
+        const int32_t minZ = ToCellCoordinate(area.min.z - m_MaxHalfExtent), maxZ = ToCellCoordinate(area.max.z + m_MaxHalfExtent);
+
+        const double rangeCells = (double)(maxX - minX + 1) * (double)(maxY - minY + 1) * (double)(maxZ - minZ + 1);
+
+        // large areas (or a sparse grid): walking the occupied cells is cheaper than hashing every cell of the range
+        if (rangeCells > (double)m_CellMap.size())
+        {
+            for (const Cell& cell : m_Cells)
+            {
+                if (!cell.Entities.empty() && CheckCollisionBoxes(cell.Bounds, area)) {
+                    func(cell);
+                }
+            }
+            return;
+        }
+
+        for (int32_t x = minX; x <= maxX; x++)
+        {
+            for (int32_t y = minY; y <= maxY; y++)
+            {
+                for (int32_t z = minZ; z <= maxZ; z++)
+                {
+                    const auto it = m_CellMap.find(MakeKey(x, y, z));
+                    if (it != m_CellMap.end() && CheckCollisionBoxes(m_Cells[it->second].Bounds, area)) {
+                        func(m_Cells[it->second]);
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Func>
+    void SpatialIndex::QueryBox(const BoundingBox& box, Func&& callback) const
+    {
+        auto visit = [&](const Cell& cell) {
+            for (size_t i = 0; i < cell.Entities.size(); i++)
+            {
+                if (CheckCollisionBoxes(cell.Boxes[i], box)) {
+                    callback(cell.Entities[i], cell.Boxes[i]);
+                }
+            }
+        };
+
+        ForEachCell(box, visit);
+        visit(m_Oversized);
+    }
+
+    template <typename Func>
+    void SpatialIndex::QuerySphere(const Vector3& center, float radius, Func&& callback) const
+    {
+        auto visit = [&](const Cell& cell) {
+            if (!BoxOverlapsSphere(cell.Bounds, center, radius)) {
+                return;
+            }
+
+            for (size_t i = 0; i < cell.Entities.size(); i++)
+            {
+                if (BoxOverlapsSphere(cell.Boxes[i], center, radius)) {
+                    callback(cell.Entities[i], cell.Boxes[i]);
+                }
+            }
+        };
+
+        const BoundingBox area = {
+            {center.x - radius, center.y - radius, center.z - radius},
+            {center.x + radius, center.y + radius, center.z + radius}
+        };
+
+        ForEachCell(area, visit);
+        visit(m_Oversized);
+    }
+
+    template <typename Func>
+    void SpatialIndex::QueryFrustum(const Math::Frustum& frustum, Func&& callback) const
+    {
+        // the frustum has no cheap cell range, every occupied cell is tested against the planes instead
+        auto visit = [&](const Cell& cell) {
+            if (cell.Entities.empty() || !BoxOverlapsFrustum(frustum, cell.Bounds)) {
+                return;
+            }
+
+            for (size_t i = 0; i < cell.Entities.size(); i++)
+            {
+                if (BoxOverlapsFrustum(frustum, cell.Boxes[i])) {
+                    callback(cell.Entities[i], cell.Boxes[i]);
+                }
+            }
+        };
+
+        for (const Cell& cell : m_Cells) {
+            visit(cell);
+        }
+        visit(m_Oversized);
+    }
+
+    template <typename Func>
+    void SpatialIndex::QueryRay(const Ray& ray, float maxDistance, Func&& callback) const
+    {
+        const Vector3 inverseDirection = {
+            ray.direction.x != 0.0f ? 1.0f / ray.direction.x : FLT_MAX,
+            ray.direction.y != 0.0f ? 1.0f / ray.direction.y : FLT_MAX,
+            ray.direction.z != 0.0f ? 1.0f / ray.direction.z : FLT_MAX
+        };
+
+        auto visit = [&](const Cell& cell) {
+            if (Math::RayBoxDistance(ray.position, inverseDirection, cell.Bounds) >= maxDistance) {
+                return;
+            }
+
+            for (size_t i = 0; i < cell.Entities.size(); i++)
+            {
+                const float distance = Math::RayBoxDistance(ray.position, inverseDirection, cell.Boxes[i]);
+                if (distance < maxDistance) {
+                    callback(cell.Entities[i], distance);
+                }
+            }
+        };
+
+        // the cells around the segment, an unbounded ray ends up walking every occupied cell
+        const float length = std::isfinite(maxDistance) ? std::min(maxDistance, 1e7f) : 1e7f;
+        const Vector3 end = {
+            ray.position.x + ray.direction.x * length,
+            ray.position.y + ray.direction.y * length,
+            ray.position.z + ray.direction.z * length
+        };
+        const BoundingBox area = {
+            {std::min(ray.position.x, end.x), std::min(ray.position.y, end.y), std::min(ray.position.z, end.z)},
+            {std::max(ray.position.x, end.x), std::max(ray.position.y, end.y), std::max(ray.position.z, end.z)}
+        };
+
+        ForEachCell(area, visit);
+        visit(m_Oversized);
+    }
+}
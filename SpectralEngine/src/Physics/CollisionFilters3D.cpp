@@ -0,0 +1,96 @@
+//
+//  CollisionFilters3D.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "CollisionFilters3D.hpp"
+
+namespace Spectral {
+
+    static constexpr uint8_t BroadPhaseBit(BroadPhaseLayer3D layer)
+    {
+        return (uint8_t)(1u << (uint32_t)layer);
+    }
+
+    JPH::BroadPhaseLayer BroadPhaseLayerInterface3D::GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const
+    {
+        JPH_ASSERT(CollisionTable3D::GetBroadPhase(inLayer) < BroadPhaseLayer3D::Count);
+        return JPH::BroadPhaseLayer((JPH::BroadPhaseLayer::Type)CollisionTable3D::GetBroadPhase(inLayer));
+    }
+
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+    const char* BroadPhaseLayerInterface3D::GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const
+    {
+        switch ((BroadPhaseLayer3D)(JPH::BroadPhaseLayer::Type)inLayer)
+        {
+            case BroadPhaseLayer3D::Static:    return "STATIC";
+            case BroadPhaseLayer3D::Dynamic:   return "DYNAMIC";
+            case BroadPhaseLayer3D::Kinematic: return "KINEMATIC";
+            case BroadPhaseLayer3D::Trigger:   return "TRIGGER";
+            case BroadPhaseLayer3D::Debris:    return "DEBRIS";
+            default:
+                JPH_ASSERT(false);
+                return "INVALID";
+        }
+    }
+#endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
+
+    bool ObjectLayerPairFilter3D::ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const
+    {
+        // two static bodies never collide
+        if (CollisionTable3D::GetBroadPhase(inObject1) == BroadPhaseLayer3D::Static && CollisionTable3D::GetBroadPhase(inObject2) == BroadPhaseLayer3D::Static) {
+            return false;
+        }
+        
+        return (m_Table.Masks[CollisionTable3D::GetLayer(inObject1)] >> CollisionTable3D::GetLayer(inObject2)) & 1;
+    }
+
+    bool ObjectVsBroadPhaseLayerFilter3D::ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const
+    {
+        const BroadPhaseLayer3D broadPhase = (BroadPhaseLayer3D)(JPH::BroadPhaseLayer::Type)inLayer2;
+        
+        // static bodies never have to look into the static tree
+        if (CollisionTable3D::GetBroadPhase(inLayer1) == BroadPhaseLayer3D::Static && broadPhase == BroadPhaseLayer3D::Static) {
+            return false;
+        }
+        
+        return (m_Table.BroadPhaseMasks[CollisionTable3D::GetLayer(inLayer1)] & BroadPhaseBit(broadPhase)) != 0;
+    }
+
+    void CollisionFilters3D::SetMatrix(const CollisionMatrix3D& matrix)
+    {
+        m_Table = CollisionTable3D();
+        
+        // broadphase layers each matrix layer can end up in
+        uint8_t layerBroadPhases[CollisionMatrix3D::MaxLayers] = {};
+        for (uint32_t i = 0; i < matrix.GetLayerCount(); i++)
+        {
+            switch (matrix.Layers[i].Type)
+            {
+                case CollisionMatrix3D::LayerType::Default:
+                    layerBroadPhases[i] = BroadPhaseBit(BroadPhaseLayer3D::Static) | BroadPhaseBit(BroadPhaseLayer3D::Dynamic) | BroadPhaseBit(BroadPhaseLayer3D::Kinematic);
+                    break;
+                case CollisionMatrix3D::LayerType::Trigger:
+                    layerBroadPhases[i] = BroadPhaseBit(BroadPhaseLayer3D::Trigger);
+                    break;
+                case CollisionMatrix3D::LayerType::Debris:
+                    layerBroadPhases[i] = BroadPhaseBit(BroadPhaseLayer3D::Debris);
+                    break;
+            }
+        }
+        
+        for (uint32_t i = 0; i < matrix.GetLayerCount(); i++)
+        {
+            m_Table.Masks[i] = matrix.Masks[i];
+            
+            for (uint32_t j = 0; j < matrix.GetLayerCount(); j++)
+            {
+                if (matrix.ShouldCollide(i, j)) {
+                    m_Table.BroadPhaseMasks[i] |= layerBroadPhases[j];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+//
+//  CollisionFilters3D.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/ObjectLayer.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
+
+#include "CollisionMatrix3D.hpp"
+
+namespace Spectral {
+
+    // Lookup tables built from a CollisionMatrix3D, shared by the Jolt filters below.
+    // A Jolt object layer packs the matrix layer and the broadphase layer of the body: (layer << 3) | broadphase
+    struct CollisionTable3D
+    {
+        uint16_t Masks[CollisionMatrix3D::MaxLayers] = {};           // same as CollisionMatrix3D::Masks
+        uint8_t BroadPhaseMasks[CollisionMatrix3D::MaxLayers] = {}; // bit b is set when a layer can collide with something in broadphase layer b
+        
+        static JPH::ObjectLayer MakeObjectLayer(uint32_t layer, BroadPhaseLayer3D broadPhase) { return (JPH::ObjectLayer)((layer << 3) | (uint32_t)broadPhase); }
+        static uint32_t GetLayer(JPH::ObjectLayer objectLayer) { return objectLayer >> 3; }
+        static BroadPhaseLayer3D GetBroadPhase(JPH::ObjectLayer objectLayer) { return (BroadPhaseLayer3D)(objectLayer & 7); }
+    };
+
+    // maps object layers to broadphase layers (required by PhysicsSystem init)
+    class BroadPhaseLayerInterface3D final : public JPH::BroadPhaseLayerInterface
+    {
+    public:
+        virtual JPH::uint GetNumBroadPhaseLayers() const override { return (JPH::uint)BroadPhaseLayer3D::Count; }
+        virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override;
+        
+    #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+        virtual const char* GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const override;
+    #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
+    };
+
+    // determines if two object layers can collide (required by PhysicsSystem init)
+    class ObjectLayerPairFilter3D final : public JPH::ObjectLayerPairFilter
+    {
+    public:
+        ObjectLayerPairFilter3D(const CollisionTable3D& table) : m_Table(table) {}
+        
+        virtual bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override;
+        
+    private:
+        const CollisionTable3D& m_Table;
+    };
+
+    // determines if an object layer can collide with a broadphase layer (required by PhysicsSystem init)
+    class ObjectVsBroadPhaseLayerFilter3D final : public JPH::ObjectVsBroadPhaseLayerFilter
+    {
+    public:
+        ObjectVsBroadPhaseLayerFilter3D(const CollisionTable3D& table) : m_Table(table) {}
+        
+        virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override;
+        
+    private:
+        const CollisionTable3D& m_Table;
+    };
+
+    // all the filters of one physics world
+    class CollisionFilters3D
+    {
+    public:
+        CollisionFilters3D() : m_ObjectLayerPairFilter(m_Table), m_ObjectVsBroadPhaseLayerFilter(m_Table) {}
+        
+        // @NOTE: must not be called while the world is being stepped
+        void SetMatrix(const CollisionMatrix3D& matrix);
+        
+        const BroadPhaseLayerInterface3D& GetBroadPhaseLayerInterface() const { return m_BroadPhaseLayerInterface; }
+        const ObjectLayerPairFilter3D& GetObjectLayerPairFilter() const { return m_ObjectLayerPairFilter; }
+        const ObjectVsBroadPhaseLayerFilter3D& GetObjectVsBroadPhaseLayerFilter() const { return m_ObjectVsBroadPhaseLayerFilter; }
+        
+    private:
+        CollisionTable3D m_Table;
+        
+        BroadPhaseLayerInterface3D m_BroadPhaseLayerInterface;
+        ObjectLayerPairFilter3D m_ObjectLayerPairFilter;
+        ObjectVsBroadPhaseLayerFilter3D m_ObjectVsBroadPhaseLayerFilter;
+    };
+}
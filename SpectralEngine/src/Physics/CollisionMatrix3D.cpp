@@ -0,0 +1,86 @@
+//
+//  CollisionMatrix3D.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "CollisionMatrix3D.hpp"
+
+namespace Spectral {
+
+    CollisionMatrix3D::CollisionMatrix3D()
+    {
+        // @NOTE: the first four layers keep the indices of the old fixed layers, so existing scenes keep their LayerMask.
+        // Each of them collides with itself like before, the pairs between them are new
+        const int32_t staticLayer = AddLayer("Static");
+        const int32_t defaultLayer = AddLayer("Default");
+        const int32_t custom1 = AddLayer("Custom1");
+        const int32_t custom2 = AddLayer("Custom2");
+        const int32_t trigger = AddLayer("Trigger", LayerType::Trigger);
+        const int32_t debris = AddLayer("Debris", LayerType::Debris);
+        
+        SetCollision(staticLayer, staticLayer, true);
+        SetCollision(defaultLayer, defaultLayer, true);
+        SetCollision(custom1, custom1, true);
+        SetCollision(custom2, custom2, true);
+        
+        SetCollision(staticLayer, defaultLayer, true);
+        SetCollision(staticLayer, custom1, true);
+        SetCollision(staticLayer, custom2, true);
+        SetCollision(staticLayer, debris, true);
+        
+        SetCollision(trigger, defaultLayer, true);
+    }
+
+    int32_t CollisionMatrix3D::FindLayer(const std::string& name) const
+    {
+        for (uint32_t i = 0; i < Layers.size(); i++)
+        {
+            if (Layers[i].Name == name) {
+                return (int32_t)i;
+            }
+        }
+        return -1;
+    }
+
+    int32_t CollisionMatrix3D::AddLayer(const std::string& name, LayerType type)
+    {
+        if (Layers.size() >= MaxLayers) {
+            return -1;
+        }
+        
+        Layers.push_back({name, type});
+        Masks[Layers.size() - 1] = 0;
+        return (int32_t)Layers.size() - 1;
+    }
+
+    void CollisionMatrix3D::SetCollision(uint32_t layerA, uint32_t layerB, bool collide)
+    {
+        if (collide)
+        {
+            Masks[layerA] |= (uint16_t)(1u << layerB);
+            Masks[layerB] |= (uint16_t)(1u << layerA);
+        }
+        else
+        {
+            Masks[layerA] &= (uint16_t)~(1u << layerB);
+            Masks[layerB] &= (uint16_t)~(1u << layerA);
+        }
+    }
+
+    bool CollisionMatrix3D::operator==(const CollisionMatrix3D& other) const
+    {
+        if (Layers.size() != other.Layers.size()) {
+            return false;
+        }
+        
+        for (uint32_t i = 0; i < Layers.size(); i++)
+        {
+            if (Layers[i].Name != other.Layers[i].Name || Layers[i].Type != other.Layers[i].Type || Masks[i] != other.Masks[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  CollisionMatrix3D.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Spectral {
+
+    // Broadphase trees of the 3D physics world, each one is a separate bounding volume tree in Jolt.
+    // Keeping static bodies in their own tree avoids updating it every step, triggers and debris are only tested against the layers they collide with
+    enum class BroadPhaseLayer3D : uint8_t { Static = 0, Dynamic, Kinematic, Trigger, Debris, Count };
+
+    // Object layers and which of them collide with each other, configured per scene and serialized with it.
+    // IDComponent::LayerMask is the index of the layer of an entity
+    struct CollisionMatrix3D
+    {
+        static constexpr uint32_t MaxLayers = 16;
+        
+        enum class LayerType : uint8_t
+        {
+            Default = 0, // static, dynamic or kinematic tree, depending on the motion type of the body
+            Trigger,     // sensor bodies (no collision response) in the trigger tree
+            Debris       // small dynamic bodies in the debris tree, usually only colliding with static geometry
+        };
+        
+        struct Layer
+        {
+            std::string Name;
+            LayerType Type = LayerType::Default;
+        };
+        
+        std::vector<Layer> Layers;
+        uint16_t Masks[MaxLayers] = {}; // bit j of Masks[i] is set when layer i collides with layer j (always symmetric)
+        
+        CollisionMatrix3D(); // Static, Default, Custom1, Custom2, Trigger and Debris, see CollisionMatrix3D.cpp
+        
+        uint32_t GetLayerCount() const { return (uint32_t)Layers.size(); }
+        int32_t FindLayer(const std::string& name) const; // -1 when there is no layer with this name
+        
+        // returns the index of the new layer, or -1 once MaxLayers is reached
+        int32_t AddLayer(const std::string& name, LayerType type = LayerType::Default);
+        
+        void SetCollision(uint32_t layerA, uint32_t layerB, bool collide);
+        bool ShouldCollide(uint32_t layerA, uint32_t layerB) const { return (Masks[layerA] >> layerB) & 1; }
+        
+        bool operator==(const CollisionMatrix3D& other) const;
+        bool operator!=(const CollisionMatrix3D& other) const { return !(*this == other); }
+    };
+}
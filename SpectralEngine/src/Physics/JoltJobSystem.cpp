@@ -0,0 +1,81 @@
+//
+//  JoltJobSystem.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "JoltJobSystem.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include <thread>
+
+namespace Spectral {
+
+    JoltJobSystem::JoltJobSystem(JPH::uint maxJobs, JPH::uint maxBarriers)
+        : JPH::JobSystemWithBarrier(maxBarriers)
+    {
+        m_Jobs.Init(maxJobs, maxJobs);
+    }
+
+    int JoltJobSystem::GetMaxConcurrency() const
+    {
+        return (int)Spectral::JobSystem::GetThreadCount();
+    }
+
+    JoltJobSystem::JobHandle JoltJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies)
+    {
+        // same as JobSystemThreadPool, wait until a job gets free when the free list is exhausted
+        JPH::uint32 index;
+        while (true)
+        {
+            index = m_Jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+            if (index != AvailableJobs::cInvalidObjectIndex) {
+                break;
+            }
+
+            JPH_ASSERT(false, "No jobs available!");
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        Job* job = &m_Jobs.Get(index);
+
+        // construct the handle first to keep a reference, the job may complete right after it is queued
+        JobHandle handle(job);
+
+        if (inNumDependencies == 0) {
+            QueueJob(job);
+        }
+
+        return handle;
+    }
+
+    void JoltJobSystem::QueueJob(Job* inJob)
+    {
+        // without workers the job is executed by the barrier when the physics system waits for it
+        if (Spectral::JobSystem::GetThreadCount() <= 1) {
+            return;
+        }
+
+        // @NOTE: JobSystem alone would name the JPH::JobSystem base class here
+        // keep the job alive while it is in the queue, Execute() does nothing if the barrier already ran it
+        inJob->AddRef();
+
+        Spectral::JobSystem::Run([inJob]() {
+            inJob->Execute();
+            inJob->Release();
+        });
+    }
+
+    void JoltJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+    {
+        for (JPH::uint i = 0; i < inNumJobs; i++) {
+            QueueJob(inJobs[i]);
+        }
+    }
+
+    void JoltJobSystem::FreeJob(Job* inJob)
+    {
+        m_Jobs.DestructObject(inJob);
+    }
+}
@@ -0,0 +1,34 @@
+//
+//  JoltJobSystem.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+
+namespace Spectral {
+
+    // Runs the Jolt physics jobs on the engine JobSystem, so physics and the scene update share the same worker threads
+    // instead of Jolt starting a thread pool of its own
+    class JoltJobSystem final : public JPH::JobSystemWithBarrier
+    {
+    public:
+        JoltJobSystem(JPH::uint maxJobs, JPH::uint maxBarriers);
+
+        virtual int GetMaxConcurrency() const override;
+        virtual JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+    protected:
+        virtual void QueueJob(Job* inJob) override;
+        virtual void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+        virtual void FreeJob(Job* inJob) override;
+
+    private:
+        using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+        AvailableJobs m_Jobs;
+    };
+}
@@ -8,35 +8,30 @@
 
 // fwd declaration
 namespace JPH {
-    class PhysicsSystem;
     class TempAllocator;
-    class JobSystemThreadPool;
+    class JobSystem;
 }
 
 namespace Spectral {
     
     // fwd declaration
-    class BPLayerInterfaceImpl;
-    class ObjectLayerPairFilterImpl;
-    class ObjectVsBroadPhaseLayerFilterImpl;
+    class JoltJobSystem;
     
+    // Process wide Jolt resources (factory, temp allocator and job system), created once and shared by every
+    // PhysicsWorld3D. Init() and Shutdown() are called by the Application, the physics worlds themselves belong to the scenes
     class PhysicsEngine3D
     {
     public:
         static void Init();
         static void Shutdown();
-        static void StepPhysics(float ts);
+        static bool IsInitialized() { return s_Allocator != nullptr; }
         
-        static JPH::PhysicsSystem& GetPhysicsSystem();
+        static JPH::TempAllocator& GetTempAllocator();
+        static JPH::JobSystem& GetJobSystem();
         
     private:
-        static JPH::PhysicsSystem* s_PhysicsSystem;
         static JPH::TempAllocator* s_Allocator;
-        static JPH::JobSystemThreadPool* s_JobSystemThreadPool;
-        
-        static BPLayerInterfaceImpl* s_BPLayerInterface;
-        static ObjectLayerPairFilterImpl* s_ObjectLayerPairFilter;
-        static ObjectVsBroadPhaseLayerFilterImpl* s_ObjectVSBroadPhaserLayerFilert;
+        static JoltJobSystem* s_JobSystem;
     };
 }
 
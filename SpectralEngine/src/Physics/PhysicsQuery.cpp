@@ -0,0 +1,367 @@
+//
+//  PhysicsQuery.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "PhysicsQuery.hpp"
+#include "PhysicsWorld3D.hpp"
+#include "CollisionFilters3D.hpp"
+
+#include "Core/Scene.hpp"
+#include "Core/JobSystem.hpp"
+
+#include "raymath.h"
+#include "box2d/box2d.h"
+
+// Jolt includes
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+
+#include <algorithm>
+
+namespace Spectral {
+
+    namespace {
+        // batches are split in ranges of this many queries
+        constexpr size_t c_QueryGrainSize = 16;
+
+        JPH::Vec3 ToJolt(const Vector3& v) { return JPH::Vec3(v.x, v.y, v.z); }
+        Vector3 FromJolt(JPH::Vec3Arg v) { return {v.GetX(), v.GetY(), v.GetZ()}; }
+
+        // the trigger tree is skipped unless the query asks for triggers
+        class QueryBroadPhaseLayerFilter final : public JPH::BroadPhaseLayerFilter
+        {
+        public:
+            QueryBroadPhaseLayerFilter(const QueryFilter& filter) : m_HitTriggers(filter.HitTriggers) {}
+
+            virtual bool ShouldCollide(JPH::BroadPhaseLayer inLayer) const override
+            {
+                return m_HitTriggers || (BroadPhaseLayer3D)(JPH::BroadPhaseLayer::Type)inLayer != BroadPhaseLayer3D::Trigger;
+            }
+
+        private:
+            bool m_HitTriggers;
+        };
+
+        class QueryObjectLayerFilter final : public JPH::ObjectLayerFilter
+        {
+        public:
+            QueryObjectLayerFilter(const QueryFilter& filter) : m_Layers(filter.Layers) {}
+
+            virtual bool ShouldCollide(JPH::ObjectLayer inLayer) const override
+            {
+                return (m_Layers >> CollisionTable3D::GetLayer(inLayer)) & 1;
+            }
+
+        private:
+            uint16_t m_Layers;
+        };
+
+        // the user data of every body is its entity, see Scene::CreateBodies3D()
+        class QueryBodyFilter final : public JPH::BodyFilter
+        {
+        public:
+            QueryBodyFilter(const QueryFilter& filter) : m_Ignore(filter.Ignore) {}
+
+            virtual bool ShouldCollideLocked(const JPH::Body& inBody) const override
+            {
+                return m_Ignore == entt::null || (entt::entity)inBody.GetUserData() != m_Ignore;
+            }
+
+        private:
+            entt::entity m_Ignore;
+        };
+
+        struct QueryFilters3D
+        {
+            QueryBroadPhaseLayerFilter BroadPhase;
+            QueryObjectLayerFilter ObjectLayer;
+            QueryBodyFilter Body;
+
+            QueryFilters3D(const QueryFilter& filter) : BroadPhase(filter), ObjectLayer(filter), Body(filter) {}
+        };
+
+        // collects each body once, compound shapes report one hit per sub shape
+        void AppendBodies(JPH::PhysicsSystem& physicsSystem, JPH::AllHitCollisionCollector<JPH::CollideShapeCollector>& collector, std::vector<entt::entity>& entities, size_t first)
+        {
+            const JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+            for (const JPH::CollideShapeResult& result : collector.mHits)
+            {
+                const entt::entity entity = (entt::entity)bodyInterface.GetUserData(result.mBodyID2);
+                if (std::find(entities.begin() + first, entities.end(), entity) == entities.end()) {
+                    entities.push_back(entity);
+                }
+            }
+        }
+
+        // closest fixture along the ray
+        class ClosestRayCastCallback2D final : public b2RayCastCallback
+        {
+        public:
+            ClosestRayCastCallback2D(const QueryFilter& filter, RaycastHit2D& hit) : m_Filter(filter), m_Hit(hit) {}
+
+            virtual float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+            {
+                const entt::entity entity = (entt::entity)fixture->GetBody()->GetUserData().pointer;
+                if ((fixture->IsSensor() && !m_Filter.HitTriggers) || (m_Filter.Ignore != entt::null && entity == m_Filter.Ignore)) {
+                    return -1.0f; // ignore the fixture
+                }
+
+                m_Hit.Entity = entity;
+                m_Hit.Point = {point.x, point.y};
+                m_Hit.Normal = {normal.x, normal.y};
+                m_Hit.Fraction = fraction;
+                m_Hit.Hit = true;
+                return fraction; // clip the ray, only closer fixtures are reported next
+            }
+
+        private:
+            const QueryFilter& m_Filter;
+            RaycastHit2D& m_Hit;
+        };
+
+        // fixtures whose shape overlaps the box, the broadphase only returns the fixtures with an overlapping AABB
+        class OverlapCallback2D final : public b2QueryCallback
+        {
+        public:
+            OverlapCallback2D(const QueryFilter& filter, const b2PolygonShape& box, std::vector<entt::entity>& entities, size_t first)
+                : m_Filter(filter), m_Box(box), m_Entities(entities), m_First(first) {}
+
+            virtual bool ReportFixture(b2Fixture* fixture) override
+            {
+                const entt::entity entity = (entt::entity)fixture->GetBody()->GetUserData().pointer;
+                if ((fixture->IsSensor() && !m_Filter.HitTriggers) || (m_Filter.Ignore != entt::null && entity == m_Filter.Ignore)) {
+                    return true;
+                }
+
+                b2Transform identity;
+                identity.SetIdentity();
+                if (b2TestOverlap(fixture->GetShape(), 0, &m_Box, 0, fixture->GetBody()->GetTransform(), identity)
+                    && std::find(m_Entities.begin() + m_First, m_Entities.end(), entity) == m_Entities.end())
+                {
+                    m_Entities.push_back(entity);
+                }
+                return true; // keep going
+            }
+
+        private:
+            const QueryFilter& m_Filter;
+            const b2PolygonShape& m_Box;
+            std::vector<entt::entity>& m_Entities;
+            size_t m_First;
+        };
+    }
+
+    bool PhysicsQuery::Raycast(const RaycastQuery& query, RaycastHit& hit) const
+    {
+        hit = RaycastHit();
+
+        const float length = Vector3Length(query.Direction);
+        if (!m_Scene->m_PhysicsWorld3D || length <= 0.0f || query.MaxDistance <= 0.0f) {
+            return false;
+        }
+
+        JPH::PhysicsSystem& physicsSystem = m_Scene->m_PhysicsWorld3D->GetPhysicsSystem();
+        const QueryFilters3D filters(query.Filter);
+
+        const JPH::RRayCast ray(ToJolt(query.Origin), ToJolt(Vector3Scale(query.Direction, query.MaxDistance / length)));
+        JPH::RayCastResult result;
+        if (!physicsSystem.GetNarrowPhaseQuery().CastRay(ray, result, filters.BroadPhase, filters.ObjectLayer, filters.Body)) {
+            return false;
+        }
+
+        // the normal needs the shape of the body
+        JPH::BodyLockRead lock(physicsSystem.GetBodyLockInterface(), result.mBodyID);
+        if (!lock.Succeeded()) {
+            return false;
+        }
+
+        const JPH::Body& body = lock.GetBody();
+        const JPH::RVec3 point = ray.GetPointOnRay(result.mFraction);
+
+        hit.Entity = (entt::entity)body.GetUserData();
+        hit.Point = FromJolt(point);
+        hit.Normal = FromJolt(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, point));
+        hit.Distance = result.mFraction * query.MaxDistance;
+        hit.Hit = true;
+        return true;
+    }
+
+    bool PhysicsQuery::SphereCast(const SphereCastQuery& query, RaycastHit& hit) const
+    {
+        hit = RaycastHit();
+
+        const float length = Vector3Length(query.Direction);
+        if (!m_Scene->m_PhysicsWorld3D || length <= 0.0f || query.MaxDistance <= 0.0f || query.Radius <= 0.0f) {
+            return false;
+        }
+
+        JPH::PhysicsSystem& physicsSystem = m_Scene->m_PhysicsWorld3D->GetPhysicsSystem();
+        const QueryFilters3D filters(query.Filter);
+
+        JPH::SphereShape sphere(query.Radius);
+        sphere.SetEmbedded(); // lives on the stack, never ref counted
+
+        const JPH::RShapeCast shapeCast = JPH::RShapeCast::sFromWorldTransform(&sphere, JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sTranslation(ToJolt(query.Origin)),
+                                                                               ToJolt(Vector3Scale(query.Direction, query.MaxDistance / length)));
+        JPH::ShapeCastSettings settings;
+        JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+        physicsSystem.GetNarrowPhaseQuery().CastShape(shapeCast, settings, JPH::RVec3::sZero(), collector, filters.BroadPhase, filters.ObjectLayer, filters.Body);
+
+        if (!collector.HadHit()) {
+            return false;
+        }
+
+        const JPH::ShapeCastResult& result = collector.mHit;
+        hit.Entity = (entt::entity)physicsSystem.GetBodyInterface().GetUserData(result.mBodyID2);
+        hit.Point = FromJolt(result.mContactPointOn2);
+        hit.Normal = FromJolt(-result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()));
+        hit.Distance = result.mFraction * query.MaxDistance;
+        hit.Hit = true;
+        return true;
+    }
+
+    bool PhysicsQuery::Linecast(const LinecastQuery& query) const
+    {
+        if (!m_Scene->m_PhysicsWorld3D || Vector3Equals(query.From, query.To)) {
+            return false;
+        }
+
+        JPH::PhysicsSystem& physicsSystem = m_Scene->m_PhysicsWorld3D->GetPhysicsSystem();
+        const QueryFilters3D filters(query.Filter);
+
+        const JPH::RRayCast ray(ToJolt(query.From), ToJolt(Vector3Subtract(query.To, query.From)));
+        JPH::RayCastSettings settings;
+        JPH::AnyHitCollisionCollector<JPH::CastRayCollector> collector;
+        physicsSystem.GetNarrowPhaseQuery().CastRay(ray, settings, collector, filters.BroadPhase, filters.ObjectLayer, filters.Body);
+
+        return collector.HadHit();
+    }
+
+    size_t PhysicsQuery::OverlapSphere(const Vector3& center, float radius, std::vector<entt::entity>& entities, const QueryFilter& filter) const
+    {
+        if (!m_Scene->m_PhysicsWorld3D || radius <= 0.0f) {
+            return 0;
+        }
+
+        JPH::PhysicsSystem& physicsSystem = m_Scene->m_PhysicsWorld3D->GetPhysicsSystem();
+        const QueryFilters3D filters(filter);
+
+        JPH::SphereShape sphere(radius);
+        sphere.SetEmbedded();
+
+        JPH::CollideShapeSettings settings;
+        JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+        physicsSystem.GetNarrowPhaseQuery().CollideShape(&sphere, JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sTranslation(ToJolt(center)), settings, JPH::RVec3::sZero(), collector,
+                                                         filters.BroadPhase, filters.ObjectLayer, filters.Body);
+
+        const size_t first = entities.size();
+        AppendBodies(physicsSystem, collector, entities, first);
+        return entities.size() - first;
+    }
+
+    size_t PhysicsQuery::OverlapBox(const Vector3& center, const Vector3& halfExtents, const Quaternion& rotation, std::vector<entt::entity>& entities, const QueryFilter& filter) const
+    {
+        const float minHalfExtent = std::min(halfExtents.x, std::min(halfExtents.y, halfExtents.z));
+        if (!m_Scene->m_PhysicsWorld3D || minHalfExtent <= 0.0f) {
+            return 0;
+        }
+
+        JPH::PhysicsSystem& physicsSystem = m_Scene->m_PhysicsWorld3D->GetPhysicsSystem();
+        const QueryFilters3D filters(filter);
+
+        // the convex radius can't be bigger than the box
+        JPH::BoxShape box(ToJolt(halfExtents), std::min(JPH::cDefaultConvexRadius, minHalfExtent));
+        box.SetEmbedded();
+
+        const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(JPH::Quat(rotation.x, rotation.y, rotation.z, rotation.w).Normalized(), ToJolt(center));
+
+        JPH::CollideShapeSettings settings;
+        JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+        physicsSystem.GetNarrowPhaseQuery().CollideShape(&box, JPH::Vec3::sReplicate(1.0f), transform, settings, JPH::RVec3::sZero(), collector,
+                                                         filters.BroadPhase, filters.ObjectLayer, filters.Body);
+
+        const size_t first = entities.size();
+        AppendBodies(physicsSystem, collector, entities, first);
+        return entities.size() - first;
+    }
+
+    bool PhysicsQuery::Raycast2D(const RaycastQuery2D& query, RaycastHit2D& hit) const
+    {
+        hit = RaycastHit2D();
+
+        // box2d asserts on zero length rays
+        if (!m_Scene->m_PhysicsWorld || (query.From.x == query.To.x && query.From.y == query.To.y)) {
+            return false;
+        }
+
+        ClosestRayCastCallback2D callback(query.Filter, hit);
+        m_Scene->m_PhysicsWorld->RayCast(&callback, b2Vec2(query.From.x, query.From.y), b2Vec2(query.To.x, query.To.y));
+        return hit.Hit;
+    }
+
+    size_t PhysicsQuery::OverlapBox2D(const Vector2& center, const Vector2& halfExtents, std::vector<entt::entity>& entities, const QueryFilter& filter) const
+    {
+        if (!m_Scene->m_PhysicsWorld || halfExtents.x <= 0.0f || halfExtents.y <= 0.0f) {
+            return 0;
+        }
+
+        b2PolygonShape box;
+        box.SetAsBox(halfExtents.x, halfExtents.y, b2Vec2(center.x, center.y), 0.0f);
+
+        b2AABB aabb;
+        aabb.lowerBound.Set(center.x - halfExtents.x, center.y - halfExtents.y);
+        aabb.upperBound.Set(center.x + halfExtents.x, center.y + halfExtents.y);
+
+        const size_t first = entities.size();
+        OverlapCallback2D callback(filter, box, entities, first);
+        m_Scene->m_PhysicsWorld->QueryAABB(&callback, aabb);
+        return entities.size() - first;
+    }
+
+    void PhysicsQuery::RaycastBatch(const RaycastQuery* queries, RaycastHit* hits, size_t count) const
+    {
+        JobSystem::ParallelForRange(count, c_QueryGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Raycast(queries[i], hits[i]);
+            }
+        });
+    }
+
+    void PhysicsQuery::SphereCastBatch(const SphereCastQuery* queries, RaycastHit* hits, size_t count) const
+    {
+        JobSystem::ParallelForRange(count, c_QueryGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                SphereCast(queries[i], hits[i]);
+            }
+        });
+    }
+
+    void PhysicsQuery::LinecastBatch(const LinecastQuery* queries, uint8_t* blocked, size_t count) const
+    {
+        JobSystem::ParallelForRange(count, c_QueryGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                blocked[i] = Linecast(queries[i]) ? 1 : 0;
+            }
+        });
+    }
+
+    void PhysicsQuery::Raycast2DBatch(const RaycastQuery2D* queries, RaycastHit2D* hits, size_t count) const
+    {
+        JobSystem::ParallelForRange(count, c_QueryGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Raycast2D(queries[i], hits[i]);
+            }
+        });
+    }
+}
@@ -0,0 +1,110 @@
+//
+//  PhysicsQuery.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "raylib.h"
+#include "entt.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Spectral {
+
+    class Scene; // fwd declaration
+
+    // Filters of a single query, by default everything except the triggers is hit
+    struct QueryFilter
+    {
+        uint16_t Layers = 0xFFFF;         // bit i is set to hit the collision layer i (see CollisionMatrix3D), 3D only
+        bool HitTriggers = false;         // sensor bodies (3D) and sensor fixtures (2D)
+        entt::entity Ignore = entt::null; // usually the entity doing the query
+    };
+
+    struct RaycastHit
+    {
+        entt::entity Entity = entt::null;
+        Vector3 Point = {0.0f, 0.0f, 0.0f};
+        Vector3 Normal = {0.0f, 0.0f, 0.0f};
+        float Distance = 0.0f;
+        bool Hit = false;
+    };
+
+    struct RaycastHit2D
+    {
+        entt::entity Entity = entt::null;
+        Vector2 Point = {0.0f, 0.0f};
+        Vector2 Normal = {0.0f, 0.0f};
+        float Fraction = 0.0f; // Point = From + Fraction * (To - From)
+        bool Hit = false;
+    };
+
+    struct RaycastQuery
+    {
+        Vector3 Origin = {0.0f, 0.0f, 0.0f};
+        Vector3 Direction = {0.0f, 0.0f, 1.0f}; // does not need to be normalized
+        float MaxDistance = 1000.0f;
+        QueryFilter Filter;
+    };
+
+    struct SphereCastQuery
+    {
+        Vector3 Origin = {0.0f, 0.0f, 0.0f};
+        Vector3 Direction = {0.0f, 0.0f, 1.0f};
+        float MaxDistance = 1000.0f;
+        float Radius = 0.5f;
+        QueryFilter Filter;
+    };
+
+    struct LinecastQuery
+    {
+        Vector3 From = {0.0f, 0.0f, 0.0f};
+        Vector3 To = {0.0f, 0.0f, 0.0f};
+        QueryFilter Filter;
+    };
+
+    struct RaycastQuery2D
+    {
+        Vector2 From = {0.0f, 0.0f};
+        Vector2 To = {0.0f, 0.0f};
+        QueryFilter Filter;
+    };
+
+    // Raycasts, shape casts and overlap tests against the runtime physics worlds of a scene (Jolt for 3D, Box2D for 2D).
+    // Queries only read the worlds, they can be issued from any thread as long as the scene is not stepping its physics.
+    // The batch versions split the queries across the JobSystem workers, results[i] always belongs to queries[i]
+    class PhysicsQuery
+    {
+    public:
+        PhysicsQuery(Scene* scene) : m_Scene(scene) {}
+        
+        Scene* GetScene() const { return m_Scene; }
+
+        // 3D, closest hit
+        bool Raycast(const RaycastQuery& query, RaycastHit& hit) const;
+        bool SphereCast(const SphereCastQuery& query, RaycastHit& hit) const;
+
+        // returns true when anything is between From and To, stops at the first hit (cheaper than a raycast, e.g. line of sight)
+        bool Linecast(const LinecastQuery& query) const;
+
+        // entities overlapping the shape, appended to entities (each entity once), returns the number of entities found
+        size_t OverlapSphere(const Vector3& center, float radius, std::vector<entt::entity>& entities, const QueryFilter& filter = {}) const;
+        size_t OverlapBox(const Vector3& center, const Vector3& halfExtents, const Quaternion& rotation, std::vector<entt::entity>& entities, const QueryFilter& filter = {}) const;
+
+        // 2D, closest hit
+        bool Raycast2D(const RaycastQuery2D& query, RaycastHit2D& hit) const;
+        size_t OverlapBox2D(const Vector2& center, const Vector2& halfExtents, std::vector<entt::entity>& entities, const QueryFilter& filter = {}) const;
+
+        // batches
+        void RaycastBatch(const RaycastQuery* queries, RaycastHit* hits, size_t count) const;
+        void SphereCastBatch(const SphereCastQuery* queries, RaycastHit* hits, size_t count) const;
+        void LinecastBatch(const LinecastQuery* queries, uint8_t* blocked, size_t count) const; // uint8_t, std::vector<bool> can't be written in parallel
+        void Raycast2DBatch(const RaycastQuery2D* queries, RaycastHit2D* hits, size_t count) const;
+
+    private:
+        Scene* m_Scene = nullptr;
+    };
+}
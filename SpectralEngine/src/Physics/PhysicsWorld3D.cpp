@@ -0,0 +1,58 @@
+//
+//  PhysicsWorld3D.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "PhysicsWorld3D.hpp"
+#include "PhysicsEngine3D.hpp"
+#include "ShapeCache3D.hpp"
+#include "CollisionFilters3D.hpp"
+
+// Jolt includes
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Core/JobSystem.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+
+#include "Core/Log.hpp"
+
+namespace Spectral {
+
+    PhysicsWorld3D::PhysicsWorld3D(const Capacity& capacity)
+        : m_ShapeCache(std::make_unique<ShapeCache3D>()), m_CollisionFilters(std::make_unique<CollisionFilters3D>()), m_Capacity(capacity)
+    {
+        // lazy init for tools that do not go through the Application (benchmarks)
+        PhysicsEngine3D::Init();
+        
+        SP_LOG_INFO("PhysicsWorld3D::Create max bodies {0}, max body pairs {1}, max contact constraints {2}", capacity.MaxBodies, capacity.MaxBodyPairs, capacity.MaxContactConstraints);
+        
+        m_CollisionFilters->SetMatrix(CollisionMatrix3D());
+        
+        constexpr JPH::uint cNumBodyMutexes = 0; // auto detect
+        
+        m_PhysicsSystem = new JPH::PhysicsSystem();
+        m_PhysicsSystem->Init(capacity.MaxBodies, cNumBodyMutexes, capacity.MaxBodyPairs, capacity.MaxContactConstraints,
+                              m_CollisionFilters->GetBroadPhaseLayerInterface(),
+                              m_CollisionFilters->GetObjectVsBroadPhaseLayerFilter(),
+                              m_CollisionFilters->GetObjectLayerPairFilter());
+    }
+
+    PhysicsWorld3D::~PhysicsWorld3D()
+    {
+        // bodies first, they keep references to the cached shapes
+        delete m_PhysicsSystem;
+        m_PhysicsSystem = nullptr;
+    }
+
+    void PhysicsWorld3D::SetCollisionMatrix(const CollisionMatrix3D& matrix)
+    {
+        m_CollisionFilters->SetMatrix(matrix);
+    }
+
+    void PhysicsWorld3D::Step(float ts)
+    {
+        m_PhysicsSystem->Update(ts, 1, &PhysicsEngine3D::GetTempAllocator(), &PhysicsEngine3D::GetJobSystem());
+    }
+}
@@ -0,0 +1,64 @@
+//
+//  PhysicsWorld3D.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// fwd declaration
+namespace JPH {
+    class PhysicsSystem;
+}
+
+namespace Spectral {
+
+    // fwd declaration
+    class ShapeCache3D;
+    class CollisionFilters3D;
+    struct CollisionMatrix3D;
+
+    // Jolt physics world of a single scene, the heavy shared resources (allocator, job system, factory) come from PhysicsEngine3D.
+    // Kept alive by the scene between play sessions, it is only rebuilt when the capacity changes
+    class PhysicsWorld3D
+    {
+    public:
+        struct Capacity
+        {
+            uint32_t MaxBodies = 65536;
+            uint32_t MaxBodyPairs = 65536;
+            uint32_t MaxContactConstraints = 10240;
+            
+            bool operator==(const Capacity& other) const
+            {
+                return MaxBodies == other.MaxBodies && MaxBodyPairs == other.MaxBodyPairs && MaxContactConstraints == other.MaxContactConstraints;
+            }
+            bool operator!=(const Capacity& other) const { return !(*this == other); }
+        };
+        
+    public:
+        PhysicsWorld3D(const Capacity& capacity);
+        ~PhysicsWorld3D();
+        
+        PhysicsWorld3D(const PhysicsWorld3D&) = delete;
+        PhysicsWorld3D& operator=(const PhysicsWorld3D&) = delete;
+        
+        void Step(float ts);
+        
+        // @NOTE: only affects new contacts, call it before the bodies are added (see Scene::OnRuntimeStart())
+        void SetCollisionMatrix(const CollisionMatrix3D& matrix);
+        
+        JPH::PhysicsSystem& GetPhysicsSystem() { return *m_PhysicsSystem; }
+        ShapeCache3D& GetShapeCache() { return *m_ShapeCache; } // kept with the world, so the next play session reuses the shapes
+        const Capacity& GetCapacity() const { return m_Capacity; }
+        
+    private:
+        JPH::PhysicsSystem* m_PhysicsSystem = nullptr;
+        std::unique_ptr<ShapeCache3D> m_ShapeCache;
+        std::unique_ptr<CollisionFilters3D> m_CollisionFilters; // referenced by the physics system, outlives it
+        Capacity m_Capacity;
+    };
+}
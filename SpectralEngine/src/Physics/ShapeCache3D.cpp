@@ -0,0 +1,177 @@
+//
+//  ShapeCache3D.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "ShapeCache3D.hpp"
+
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
+#include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
+
+#include "Core/Log.hpp"
+
+#include <cstring>
+#include <mutex>
+
+namespace Spectral {
+
+    bool ShapeCache3D::Key::operator==(const Key& other) const
+    {
+        return Type == other.Type
+            && Size[0] == other.Size[0] && Size[1] == other.Size[1] && Size[2] == other.Size[2]
+            && Offset[0] == other.Offset[0] && Offset[1] == other.Offset[1] && Offset[2] == other.Offset[2]
+            && Density == other.Density;
+    }
+
+    size_t ShapeCache3D::KeyHash::operator()(const Key& key) const
+    {
+        // FNV-1a over the values, the key has no padding
+        static_assert(sizeof(Key) == sizeof(uint32_t) * 8, "Key must not have padding");
+        
+        uint32_t words[8];
+        std::memcpy(words, &key, sizeof(Key));
+        
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t word : words)
+        {
+            hash ^= word;
+            hash *= 1099511628211ull;
+        }
+        return (size_t)hash;
+    }
+
+    template<typename CreateFunc>
+    JPH::ShapeRefC ShapeCache3D::GetOrCreate(const Key& key, CreateFunc create)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_Mutex);
+            
+            auto it = m_Shapes.find(key);
+            if (it != m_Shapes.end())
+            {
+                m_Hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+        }
+        
+        JPH::ShapeRefC shape = create();
+        
+        // failures are not cached, the collider may be fixed before the next play session
+        if (shape == nullptr) {
+            return nullptr;
+        }
+        
+        // another thread may have created the same shape in the meantime, keep the first one
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        auto [it, inserted] = m_Shapes.try_emplace(key, shape);
+        
+        if (inserted) {
+            m_Misses.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_Hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        return it->second;
+    }
+
+    static JPH::ShapeRefC CreateShape(const JPH::ShapeSettings& settings, const Vector3& offset)
+    {
+        JPH::ShapeSettings::ShapeResult result;
+        
+        if (offset.x == 0.0f && offset.y == 0.0f && offset.z == 0.0f) {
+            result = settings.Create();
+        } else {
+            result = JPH::RotatedTranslatedShapeSettings({offset.x, offset.y, offset.z}, JPH::Quat::sIdentity(), &settings).Create();
+        }
+        
+        if (result.HasError())
+        {
+            SP_LOG_ERORR("ShapeCache3D::CreateShape failed: {0}", result.GetError().c_str());
+            return nullptr;
+        }
+        return result.Get();
+    }
+
+    JPH::ShapeRefC ShapeCache3D::GetBox(const Vector3& halfExtents, const Vector3& offset, float density)
+    {
+        Key key;
+        key.Type = ColliderType::Box;
+        key.Size[0] = halfExtents.x; key.Size[1] = halfExtents.y; key.Size[2] = halfExtents.z;
+        key.Offset[0] = offset.x; key.Offset[1] = offset.y; key.Offset[2] = offset.z;
+        key.Density = density;
+        
+        return GetOrCreate(key, [&]() {
+            JPH::BoxShapeSettings boxSettings({halfExtents.x, halfExtents.y, halfExtents.z});
+            boxSettings.SetEmbedded(); // lives on the stack, must not be freed by the decorated shape settings
+            boxSettings.SetDensity(density);
+            
+            return CreateShape(boxSettings, offset);
+        });
+    }
+
+    JPH::ShapeRefC ShapeCache3D::GetSphere(float radius, const Vector3& offset, float density)
+    {
+        Key key;
+        key.Type = ColliderType::Sphere;
+        key.Size[0] = radius;
+        key.Offset[0] = offset.x; key.Offset[1] = offset.y; key.Offset[2] = offset.z;
+        key.Density = density;
+        
+        return GetOrCreate(key, [&]() {
+            JPH::SphereShapeSettings sphereSettings(radius);
+            sphereSettings.SetEmbedded();
+            sphereSettings.SetDensity(density);
+            
+            return CreateShape(sphereSettings, offset);
+        });
+    }
+
+    JPH::ShapeRefC ShapeCache3D::GetEmpty()
+    {
+        return GetOrCreate(Key(), []() {
+            JPH::MutableCompoundShapeSettings compoundSettings;
+            return JPH::ShapeRefC(compoundSettings.Create().Get());
+        });
+    }
+
+    void ShapeCache3D::Prune()
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        
+        for (auto it = m_Shapes.begin(); it != m_Shapes.end();)
+        {
+            // the cache holds the only reference
+            if (it->second == nullptr || it->second->GetRefCount() == 1) {
+                it = m_Shapes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void ShapeCache3D::Clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        m_Shapes.clear();
+    }
+
+    ShapeCache3D::Stats ShapeCache3D::GetStats() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_Mutex);
+        
+        Stats stats;
+        stats.Hits = m_Hits.load(std::memory_order_relaxed);
+        stats.Misses = m_Misses.load(std::memory_order_relaxed);
+        stats.Shapes = m_Shapes.size();
+        return stats;
+    }
+
+    void ShapeCache3D::ResetStats()
+    {
+        m_Hits = 0;
+        m_Misses = 0;
+    }
+}
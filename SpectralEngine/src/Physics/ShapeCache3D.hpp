@@ -0,0 +1,76 @@
+//
+//  ShapeCache3D.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+#include "raylib.h"
+
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Spectral {
+
+    // Shares the Jolt collision shapes between identical colliders (same type, scaled size, offset and density),
+    // a scene with thousands of the same crate ends up with a single box shape. Thread safe, bodies are created in parallel.
+    class ShapeCache3D
+    {
+    public:
+        struct Stats
+        {
+            uint64_t Hits = 0;
+            uint64_t Misses = 0;
+            size_t Shapes = 0; // unique shapes in the cache
+            
+            float GetHitRate() const { return Hits + Misses > 0 ? (float)Hits / (float)(Hits + Misses) : 0.0f; }
+        };
+        
+    public:
+        // the offset is part of the shape, a RotatedTranslatedShape wraps it when it is not zero.
+        // nullptr when Jolt can't create the shape (e.g. a zero scale or radius), the error is logged
+        JPH::ShapeRefC GetBox(const Vector3& halfExtents, const Vector3& offset, float density);
+        JPH::ShapeRefC GetSphere(float radius, const Vector3& offset, float density);
+        JPH::ShapeRefC GetEmpty(); // for bodies without any collider
+        
+        // removes the shapes that are not used by any body anymore
+        void Prune();
+        void Clear();
+        
+        Stats GetStats() const;
+        void ResetStats();
+        
+    private:
+        enum class ColliderType : uint32_t { Empty = 0, Box, Sphere };
+        
+        struct Key
+        {
+            ColliderType Type = ColliderType::Empty;
+            float Size[3] = {0.0f, 0.0f, 0.0f}; // half extents for boxes, radius for spheres
+            float Offset[3] = {0.0f, 0.0f, 0.0f};
+            float Density = 0.0f;
+            
+            bool operator==(const Key& other) const;
+        };
+        
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+        
+        template<typename CreateFunc>
+        JPH::ShapeRefC GetOrCreate(const Key& key, CreateFunc create);
+        
+    private:
+        mutable std::shared_mutex m_Mutex;
+        std::unordered_map<Key, JPH::ShapeRefC, KeyHash> m_Shapes;
+        
+        std::atomic<uint64_t> m_Hits = 0;
+        std::atomic<uint64_t> m_Misses = 0;
+    };
+}
@@ -0,0 +1,84 @@
+//
+//  FrustumCuller.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "FrustumCuller.hpp"
+
+#include <cmath>
+
+namespace Spectral {
+
+    void FrustumCuller::Clear()
+    {
+        m_CenterX.clear(); m_CenterY.clear(); m_CenterZ.clear();
+        m_ExtentX.clear(); m_ExtentY.clear(); m_ExtentZ.clear();
+        m_Entities.clear();
+        m_Visible.clear();
+    }
+
+    void FrustumCuller::Reserve(size_t count)
+    {
+        m_CenterX.reserve(count); m_CenterY.reserve(count); m_CenterZ.reserve(count);
+        m_ExtentX.reserve(count); m_ExtentY.reserve(count); m_ExtentZ.reserve(count);
+        m_Entities.reserve(count);
+    }
+
+    void FrustumCuller::Add(entt::entity entity, const BoundingBox& worldBounds)
+    {
+        m_CenterX.push_back((worldBounds.min.x + worldBounds.max.x) * 0.5f);
+        m_CenterY.push_back((worldBounds.min.y + worldBounds.max.y) * 0.5f);
+        m_CenterZ.push_back((worldBounds.min.z + worldBounds.max.z) * 0.5f);
+
+        m_ExtentX.push_back((worldBounds.max.x - worldBounds.min.x) * 0.5f);
+        m_ExtentY.push_back((worldBounds.max.y - worldBounds.min.y) * 0.5f);
+        m_ExtentZ.push_back((worldBounds.max.z - worldBounds.min.z) * 0.5f);
+
+        m_Entities.push_back(entity);
+    }
+
+    const std::vector<entt::entity>& FrustumCuller::Cull(const Math::Frustum& frustum)
+    {
+        const size_t count = m_Entities.size();
+
+        m_Mask.assign(count, 1);
+        m_Visible.clear();
+
+        const float* cx = m_CenterX.data();
+        const float* cy = m_CenterY.data();
+        const float* cz = m_CenterZ.data();
+        const float* ex = m_ExtentX.data();
+        const float* ey = m_ExtentY.data();
+        const float* ez = m_ExtentZ.data();
+        uint8_t* mask = m_Mask.data();
+
+        // plane major: one branch free pass per plane, the compiler can vectorize the inner loop
+        for (int p = 0; p < 6; p++)
+        {
+            const Vector4 plane = frustum.Planes[p];
+            const float ax = fabsf(plane.x);
+            const float ay = fabsf(plane.y);
+            const float az = fabsf(plane.z);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                // signed distance of the center plus the projected radius of the box onto the plane normal
+                const float distance = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+                const float radius = ax * ex[i] + ay * ey[i] + az * ez[i];
+
+                mask[i] &= (uint8_t)(distance + radius >= 0.0f);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (mask[i]) {
+                m_Visible.push_back(m_Entities[i]);
+            }
+        }
+
+        return m_Visible;
+    }
+}
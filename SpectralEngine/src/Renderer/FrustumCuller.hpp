@@ -0,0 +1,43 @@
+//
+//  FrustumCuller.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+#include "entt.hpp"
+
+#include "Math/Math.hpp"
+
+namespace Spectral {
+
+    // Collects world space AABBs for one frame and rejects the ones outside of the view frustum.
+    // Boxes are stored as packed center/extent arrays (SoA) so the plane test runs as straight loops over floats.
+    class FrustumCuller
+    {
+    public:
+        void Clear();
+        void Reserve(size_t count);
+
+        void Add(entt::entity entity, const BoundingBox& worldBounds);
+
+        // returns the entities whose bounds intersect or are inside of the frustum
+        const std::vector<entt::entity>& Cull(const Math::Frustum& frustum);
+
+        size_t GetCandidateCount() const { return m_Entities.size(); }
+        size_t GetVisibleCount() const { return m_Visible.size(); }
+        const std::vector<entt::entity>& GetVisible() const { return m_Visible; }
+
+    private:
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+        std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+        std::vector<entt::entity> m_Entities;
+
+        std::vector<uint8_t> m_Mask;
+        std::vector<entt::entity> m_Visible;
+    };
+}
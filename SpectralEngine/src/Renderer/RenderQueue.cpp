@@ -0,0 +1,228 @@
+//
+//  RenderQueue.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "RenderQueue.hpp"
+
+#include <cstring>
+
+namespace Spectral {
+
+    static constexpr uint64_t s_LayerBits = 4;
+    static constexpr uint64_t s_ShaderBits = 10;
+    static constexpr uint64_t s_TextureBits = 12;
+    static constexpr uint64_t s_MeshBits = 13;
+    static constexpr uint64_t s_TintBits = 8;
+    static constexpr uint64_t s_DepthBits = 24;
+    static constexpr uint64_t s_OpaqueDepthBits = s_DepthBits - s_TintBits; // only reduces overdraw, coarse is enough
+
+    static constexpr uint64_t Mask(uint64_t bits) { return (1ull << bits) - 1; }
+
+    // squared distance is enough for ordering, positive floats keep their order when compared as integers
+    static uint32_t QuantizeDepth(const Vector3& viewPosition, const Matrix& transform, uint64_t depthBits)
+    {
+        const float dx = transform.m12 - viewPosition.x;
+        const float dy = transform.m13 - viewPosition.y;
+        const float dz = transform.m14 - viewPosition.z;
+        const float distance = dx*dx + dy*dy + dz*dz;
+
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+
+        // the sign bit is always 0
+        return bits >> (31 - depthBits);
+    }
+
+    // draws of the same mesh with different tints are different batches, they have to be sorted apart too
+    static uint32_t HashTint(Color tint)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &tint, sizeof(bits));
+
+        return (bits * 0x9E3779B1u) >> (32 - s_TintBits);
+    }
+
+    void RenderQueue::Begin(const Vector3& viewPosition)
+    {
+        m_ViewPosition = viewPosition;
+
+        m_Arena.Reset();
+        m_Commands.clear();
+        m_Batches.clear();
+        m_Transforms.clear();
+    }
+
+    void RenderQueue::Reserve(size_t count)
+    {
+        m_Commands.reserve(count);
+        m_Transforms.reserve(count);
+    }
+
+    uint64_t RenderQueue::MakeKey(uint32_t shader, uint32_t texture, uint32_t mesh, uint32_t tint, const Matrix& transform, bool transparent, uint8_t layer) const
+    {
+        // ids are truncated, a collision only costs an extra state change, batches still compare the real pointers
+        const uint64_t state = (((uint64_t)shader & Mask(s_ShaderBits)) << (s_TextureBits + s_MeshBits))
+                             | (((uint64_t)texture & Mask(s_TextureBits)) << s_MeshBits)
+                             | ((uint64_t)mesh & Mask(s_MeshBits));
+
+        uint64_t key = ((uint64_t)layer & Mask(s_LayerBits)) << 60;
+
+        if (transparent)
+        {
+            // back to front, depth is more important than state changes
+            const uint64_t depth = QuantizeDepth(m_ViewPosition, transform, s_DepthBits);
+
+            key |= 1ull << 59;
+            key |= ((~depth) & Mask(s_DepthBits)) << (s_ShaderBits + s_TextureBits + s_MeshBits);
+            key |= state;
+        }
+        else
+        {
+            // group by state and tint first (one instanced batch each), front to back inside of it to reduce overdraw
+            const uint64_t depth = QuantizeDepth(m_ViewPosition, transform, s_OpaqueDepthBits);
+
+            key |= state << (s_TintBits + s_OpaqueDepthBits);
+            key |= ((uint64_t)tint & Mask(s_TintBits)) << s_OpaqueDepthBits;
+            key |= depth;
+        }
+
+        return key;
+    }
+
+    void RenderQueue::SubmitModel(const Model& model, const Matrix& transform, Color tint, bool transparent, uint8_t layer)
+    {
+        for (int i = 0; i < model.meshCount; i++) {
+            SubmitMesh(model.meshes[i], model.materials[model.meshMaterial[i]], transform, tint, transparent, layer);
+        }
+    }
+
+    void RenderQueue::SubmitMesh(const Mesh& mesh, const Material& material, const Matrix& transform, Color tint, bool transparent, uint8_t layer)
+    {
+        MeshCommand* command = m_Arena.New<MeshCommand>();
+        command->MeshData = &mesh;
+        command->MaterialData = &material;
+        command->Transform = transform;
+        command->Tint = tint;
+
+        const uint32_t texture = material.maps ? material.maps[MATERIAL_MAP_DIFFUSE].texture.id : 0;
+        const uint32_t meshId = mesh.vboId ? mesh.vboId[0] : 0;
+
+        m_Commands.push_back({ MakeKey(material.shader.id, texture, meshId, HashTint(tint), transform, transparent, layer), command });
+    }
+
+    void RenderQueue::SubmitSprite(const Texture& texture, const Matrix& transform, const Vector4& tint, bool transparent, uint8_t layer)
+    {
+        SpriteCommand* command = m_Arena.New<SpriteCommand>();
+        command->SpriteTexture = texture;
+        command->Transform = transform;
+        command->Tint = tint;
+
+        // sprites go through the rlgl batch with the default shader (0), the tint doesn't break it
+        m_Commands.push_back({ MakeKey(0, texture.id, 0, 0, transform, transparent, layer), command });
+    }
+
+    void RenderQueue::Append(const RenderQueue& other)
+    {
+        m_Commands.insert(m_Commands.end(), other.m_Commands.begin(), other.m_Commands.end());
+    }
+
+    void RenderQueue::Sort()
+    {
+        RadixSort();
+        BuildBatches();
+    }
+
+    void RenderQueue::RadixSort()
+    {
+        const size_t count = m_Commands.size();
+        if (count < 2) {
+            return;
+        }
+
+        // LSD radix sort with 8 bit digits, all histograms are built in one pass
+        uint32_t histograms[8][256] = {};
+
+        for (const Command& command : m_Commands)
+        {
+            for (int pass = 0; pass < 8; pass++) {
+                histograms[pass][(command.Key >> (pass * 8)) & 0xFF]++;
+            }
+        }
+
+        m_SortBuffer.resize(count);
+
+        Command* source = m_Commands.data();
+        Command* destination = m_SortBuffer.data();
+
+        for (int pass = 0; pass < 8; pass++)
+        {
+            uint32_t* histogram = histograms[pass];
+
+            // every key has the same digit, this pass would not move anything
+            if (histogram[(source[0].Key >> (pass * 8)) & 0xFF] == count) {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                const uint32_t digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            }
+
+            for (size_t i = 0; i < count; i++) {
+                destination[histogram[(source[i].Key >> (pass * 8)) & 0xFF]++] = source[i];
+            }
+
+            std::swap(source, destination);
+        }
+
+        if (source != m_Commands.data()) {
+            m_Commands.swap(m_SortBuffer);
+        }
+    }
+
+    void RenderQueue::BuildBatches()
+    {
+        m_Batches.clear();
+        m_Transforms.clear();
+        m_Transforms.reserve(m_Commands.size());
+
+        const MeshCommand* batchMesh = nullptr;
+
+        for (const Command& command : m_Commands)
+        {
+            const CommandType type = *(const CommandType*)command.Data;
+            const bool transparent = (command.Key >> 59) & 1;
+
+            if (type == CommandType::Sprite)
+            {
+                // sprites are already batched by rlgl, keep them in order
+                m_Batches.push_back({ CommandType::Sprite, command.Data, 0, 1, transparent });
+                batchMesh = nullptr;
+                continue;
+            }
+
+            const MeshCommand* mesh = (const MeshCommand*)command.Data;
+
+            const bool sameBatch = batchMesh
+                && m_Batches.back().Transparent == transparent
+                && batchMesh->MeshData == mesh->MeshData
+                && batchMesh->MaterialData == mesh->MaterialData
+                && std::memcmp(&batchMesh->Tint, &mesh->Tint, sizeof(Color)) == 0;
+
+            if (!sameBatch)
+            {
+                m_Batches.push_back({ CommandType::Mesh, mesh, (uint32_t)m_Transforms.size(), 0, transparent });
+                batchMesh = mesh;
+            }
+
+            m_Transforms.push_back(mesh->Transform);
+            m_Batches.back().Count++;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+//  RenderQueue.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+
+#include "Core/FrameArena.hpp"
+
+namespace Spectral {
+
+    // Records the draws of one frame as small commands with a 64-bit sort key, instead of calling raylib right away.
+    // Sort() orders them to minimize state changes (opaque front to back, transparent back to front)
+    // and groups consecutive draws of the same (mesh, material, tint) into batches that can be drawn instanced.
+    //
+    // Opaque key:      | layer 4 | 0 | shader 10 | texture 12 | mesh 13 | tint hash 8 | depth 16 |
+    // Transparent key: | layer 4 | 1 | inverted depth 24 | shader 10 | texture 12 | mesh 13 |
+    //
+    // @NOTE: only works on the CPU side (no GL calls), the commands are executed by Renderer::ExecuteRenderQueue
+    class RenderQueue
+    {
+    public:
+        enum class CommandType : uint8_t { Mesh = 0, Sprite };
+
+        // payloads live in the frame arena, the type has to stay the first member
+        struct MeshCommand
+        {
+            CommandType Type = CommandType::Mesh;
+            const Mesh* MeshData = nullptr;
+            const Material* MaterialData = nullptr;
+            Matrix Transform;
+            Color Tint;
+        };
+
+        struct SpriteCommand
+        {
+            CommandType Type = CommandType::Sprite;
+            Texture SpriteTexture;
+            Matrix Transform;
+            Vector4 Tint;
+        };
+
+        struct Command
+        {
+            uint64_t Key = 0;
+            const void* Data = nullptr;
+        };
+
+        // consecutive commands drawn together, mesh batches have their transforms contiguous in GetTransforms()
+        struct Batch
+        {
+            CommandType Type = CommandType::Mesh;
+            const void* Data = nullptr; // payload of the first command of the batch
+            uint32_t Offset = 0;
+            uint32_t Count = 0;
+            bool Transparent = false;
+        };
+
+    public:
+        // clears the previous frame, depth is measured from the view position
+        void Begin(const Vector3& viewPosition);
+        void Reserve(size_t count);
+
+        // meshes and materials are referenced by address, so they must outlive the frame
+        void SubmitModel(const Model& model, const Matrix& transform, Color tint, bool transparent, uint8_t layer = 0);
+        void SubmitMesh(const Mesh& mesh, const Material& material, const Matrix& transform, Color tint, bool transparent, uint8_t layer = 0);
+        void SubmitSprite(const Texture& texture, const Matrix& transform, const Vector4& tint, bool transparent, uint8_t layer = 0);
+
+        // takes over the commands recorded by another queue (e.g. built on a worker thread),
+        // the other queue keeps owning the payloads, so it must not be cleared before this queue is executed
+        void Append(const RenderQueue& other);
+
+        // radix sorts the commands by key and builds the batches and the per-frame transform buffer
+        void Sort();
+
+        const std::vector<Command>& GetCommands() const { return m_Commands; }
+        const std::vector<Batch>& GetBatches() const { return m_Batches; }
+        const std::vector<Matrix>& GetTransforms() const { return m_Transforms; }
+
+    private:
+        uint64_t MakeKey(uint32_t shader, uint32_t texture, uint32_t mesh, uint32_t tint, const Matrix& transform, bool transparent, uint8_t layer) const;
+
+        void RadixSort();
+        void BuildBatches();
+
+    private:
+        FrameArena m_Arena;
+        Vector3 m_ViewPosition = {0.0f, 0.0f, 0.0f};
+
+        std::vector<Command> m_Commands;
+        std::vector<Command> m_SortBuffer;
+
+        std::vector<Batch> m_Batches;
+        std::vector<Matrix> m_Transforms;
+    };
+}
@@ -11,6 +11,7 @@
 #include "raymath.h"
 
 #include "Math/Math.hpp"
+#include "Shaders.hpp"
 
 
 namespace Spectral {
@@ -103,4 +104,58 @@ namespace Spectral {
 
         rlEnd();
     }
+
+    size_t Renderer::ExecuteRenderQueue(const RenderQueue& queue)
+    {
+        const std::vector<Matrix>& transforms = queue.GetTransforms();
+        size_t drawCalls = 0;
+        
+        for (const RenderQueue::Batch& batch : queue.GetBatches())
+        {
+            if (batch.Type == RenderQueue::CommandType::Sprite)
+            {
+                const auto* sprite = (const RenderQueue::SpriteCommand*)batch.Data;
+                RenderTexturedPlane(sprite->SpriteTexture, sprite->Transform, sprite->Tint);
+                drawCalls++;
+                continue;
+            }
+            
+            const auto* command = (const RenderQueue::MeshCommand*)batch.Data;
+            const Mesh& mesh = *command->MeshData;
+            Material material = *command->MaterialData;
+            
+            // same tinting as DrawModelEx, the maps are shared with the model so the color has to be restored afterwards
+            MaterialMap& diffuseMap = material.maps[MATERIAL_MAP_DIFFUSE];
+            const Color baseColor = diffuseMap.color;
+            
+            diffuseMap.color.r = (unsigned char)(((int)baseColor.r * (int)command->Tint.r) / 255);
+            diffuseMap.color.g = (unsigned char)(((int)baseColor.g * (int)command->Tint.g) / 255);
+            diffuseMap.color.b = (unsigned char)(((int)baseColor.b * (int)command->Tint.b) / 255);
+            diffuseMap.color.a = (unsigned char)(((int)baseColor.a * (int)command->Tint.a) / 255);
+            
+            // @NOTE: only materials using the default shader are instanced, custom shaders don't read the instance transform
+            const bool instanced = Shaders::IsInstancingSupported()
+                && batch.Count > 1
+                && mesh.vaoId > 0
+                && material.shader.id == rlGetShaderIdDefault();
+            
+            if (instanced)
+            {
+                material.shader = Shaders::GetInstancingShader();
+                DrawMeshInstanced(mesh, material, &transforms[batch.Offset], (int)batch.Count);
+                drawCalls++;
+            }
+            else
+            {
+                for (uint32_t i = 0; i < batch.Count; i++) {
+                    DrawMesh(mesh, material, transforms[batch.Offset + i]);
+                }
+                drawCalls += batch.Count;
+            }
+            
+            diffuseMap.color = baseColor;
+        }
+        
+        return drawCalls;
+    }
 }
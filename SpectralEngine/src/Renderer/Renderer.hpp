@@ -10,6 +10,7 @@
 #include "raylib.h"
 
 #include "RuntimeCamera.hpp"
+#include "RenderQueue.hpp"
 
 namespace Spectral {
     
@@ -19,5 +20,9 @@ namespace Spectral {
         
         static void RenderTexturedPlane(const Texture &texture, const Matrix &transform, const Vector4 &tint);
         static void RenderCameraDebugLines(std::shared_ptr<RuntimeCamera> camera, Color color);
+        
+        // executes the batches of a sorted queue, mesh batches are drawn with one instanced draw call
+        // and fall back to one draw per instance when instancing is not available, returns the number of issued draw calls
+        static size_t ExecuteRenderQueue(const RenderQueue& queue);
     };
 }
@@ -9,15 +9,35 @@
 
 #include "Core/Log.hpp"
 
+#include "rlgl.h"
+
 namespace Spectral {
 
     Shader Shaders::s_LightingShader;
+    Shader Shaders::s_InstancingShader;
+    bool Shaders::s_InstancingSupported = false;
 
     void Shaders::LoadShaders()
     {
         SP_LOG_INFO("Shaders::LoadingShaders");
         
         s_LightingShader = ::LoadShader("ressources/shaders/lighting.fs", "ressources/shaders/lighting.fs");
+        
+        s_InstancingShader = ::LoadShader("ressources/shaders/instancing.vs", "ressources/shaders/instancing.fs");
+        
+        // raylib falls back to the default shader when the files are missing or fail to compile,
+        // its locations are shared with every other default material so they must not be modified
+        if (s_InstancingShader.id != rlGetShaderIdDefault()) {
+            s_InstancingShader.locs[SHADER_LOC_MATRIX_MODEL] = ::GetShaderLocationAttrib(s_InstancingShader, "instanceTransform");
+        }
+        
+        s_InstancingSupported = rlIsInstancingSupported()
+            && s_InstancingShader.id != rlGetShaderIdDefault()
+            && s_InstancingShader.locs[SHADER_LOC_MATRIX_MODEL] != -1;
+        
+        if (!s_InstancingSupported) {
+            SP_LOG_WARN("Shaders::GPU instancing is not available, repeated meshes are drawn one by one");
+        }
     }
 
     void Shaders::UnloadShaders()
@@ -25,5 +45,8 @@ namespace Spectral {
         SP_LOG_INFO("Shaders::UnloadingShaders");
         
         ::UnloadShader(s_LightingShader);
+        ::UnloadShader(s_InstancingShader);
+        
+        s_InstancingSupported = false;
     }
 }
@@ -20,7 +20,13 @@ namespace Spectral {
         // @NOTE: For now we're only using lighting shader
         static const Shader& GetLightingShader() { return s_LightingShader; }
         
+        // used by Renderer to draw repeated meshes, the model matrix comes from the per instance "instanceTransform" attribute
+        static const Shader& GetInstancingShader() { return s_InstancingShader; }
+        static bool IsInstancingSupported() { return s_InstancingSupported; }
+        
     private:
         static Shader s_LightingShader;
+        static Shader s_InstancingShader;
+        static bool s_InstancingSupported;
     };
 }
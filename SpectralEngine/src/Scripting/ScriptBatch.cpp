@@ -0,0 +1,71 @@
+//
+//  ScriptBatch.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "ScriptBatch.hpp"
+
+namespace Spectral {
+
+    void ScriptBatch::Begin(Scene* scene)
+    {
+        m_Scene = scene;
+        m_Entities.clear();
+        m_Transforms.clear();
+        m_RigidBodies2D.clear();
+        m_Scripts.clear();
+    }
+
+    void ScriptBatch::Add(Entity entity)
+    {
+        m_Entities.push_back(entity);
+        m_Transforms.push_back(&entity.GetComponent<TransformComponent>());
+        m_RigidBodies2D.push_back(entity.HasComponent<RigidBody2DComponent>() ? &entity.GetComponent<RigidBody2DComponent>() : nullptr);
+        m_Scripts.push_back(&entity.GetComponent<LuaScriptComponent>());
+    }
+
+    sol::object ScriptBatch::GetEntity(size_t index, sol::this_state s) const
+    {
+        if (!IsValid(index)) {
+            return sol::lua_nil;
+        }
+        return sol::make_object(s, Entity(m_Entities[index - 1], m_Scene));
+    }
+
+    sol::object ScriptBatch::GetInstance(size_t index, sol::this_state s) const
+    {
+        if (!IsValid(index)) {
+            return sol::lua_nil;
+        }
+        return sol::make_object(s, m_Scripts[index - 1]->self);
+    }
+
+    TransformComponent* ScriptBatch::GetTransform(size_t index) const
+    {
+        return IsValid(index) ? m_Transforms[index - 1] : nullptr;
+    }
+
+    RigidBody2DComponent* ScriptBatch::GetRigidBody2D(size_t index) const
+    {
+        return IsValid(index) ? m_RigidBodies2D[index - 1] : nullptr;
+    }
+
+    std::tuple<float, float, float> ScriptBatch::GetPosition(size_t index) const
+    {
+        if (!IsValid(index)) {
+            return {0.0f, 0.0f, 0.0f};
+        }
+
+        const Vector3& translation = m_Transforms[index - 1]->Translation;
+        return {translation.x, translation.y, translation.z};
+    }
+
+    void ScriptBatch::SetPosition(size_t index, float x, float y, float z)
+    {
+        if (IsValid(index)) {
+            m_Transforms[index - 1]->Translation = {x, y, z};
+        }
+    }
+}
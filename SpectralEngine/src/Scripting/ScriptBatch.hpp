@@ -0,0 +1,54 @@
+//
+//  ScriptBatch.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+#include "entt.hpp"
+#include "sol.hpp"
+
+#include "Entt/Entity.hpp"
+
+#include <tuple>
+
+namespace Spectral {
+
+    // Packed view of every entity running the same script, passed to OnUpdateAll(entities, ts) once per frame instead of
+    // calling OnUpdate per entity. The component pointers are collected before the call, so an access from lua is an
+    // index into an array. Indices are 1 based like lua arrays, out of range indices return nil (zeros for positions), writes are ignored.
+    // @NOTE: OnUpdateAll must not create/destroy entities or add/remove components, the pointers would become dangling
+    class ScriptBatch
+    {
+    public:
+        void Begin(Scene* scene);
+        void Add(Entity entity);
+
+        size_t GetCount() const { return m_Entities.size(); }
+        Scene* GetScene() const { return m_Scene; }
+
+        // lua API
+        sol::object GetEntity(size_t index, sol::this_state s) const;
+        sol::object GetInstance(size_t index, sol::this_state s) const;    // self table of the entity (see OnCreate)
+        TransformComponent* GetTransform(size_t index) const;
+        RigidBody2DComponent* GetRigidBody2D(size_t index) const;          // nil when the entity has no 2D body
+
+        // plain numbers, no userdata is created: the cheapest way to move a crowd
+        std::tuple<float, float, float> GetPosition(size_t index) const;
+        void SetPosition(size_t index, float x, float y, float z);
+
+    private:
+        bool IsValid(size_t index) const { return index >= 1 && index <= m_Entities.size(); }
+
+    private:
+        Scene* m_Scene = nullptr;
+        std::vector<entt::entity> m_Entities;
+        std::vector<TransformComponent*> m_Transforms;
+        std::vector<RigidBody2DComponent*> m_RigidBodies2D;
+        std::vector<const LuaScriptComponent*> m_Scripts;
+    };
+}
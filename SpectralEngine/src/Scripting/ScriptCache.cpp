@@ -0,0 +1,205 @@
+//
+//  ScriptCache.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "ScriptCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace Spectral {
+
+    namespace {
+        std::string s_BytecodeDirectory = "cache/scripts/";
+
+        // bytecode file layout: header, source path, lua_dump output
+        struct BytecodeHeader
+        {
+            char Magic[4] = {'S', 'P', 'L', 'C'};
+            uint32_t Version = 1;
+            int64_t ModifiedTime = 0; // of the source file the bytecode was compiled from
+            uint64_t Size = 0;
+            uint32_t PathLength = 0;
+        };
+
+        std::filesystem::path GetBytecodePath(const std::string& path)
+        {
+            // one file per script, the path is also stored in the file so a hash collision is detected
+            std::stringstream name;
+            name << std::hex << std::hash<std::string>{}(path) << ".luac";
+            return std::filesystem::path(s_BytecodeDirectory) / name.str();
+        }
+    }
+
+    sol::protected_function ScriptCache::Load(sol::state& lua, const std::string& path)
+    {
+        std::error_code error;
+        Entry source;
+        source.ModifiedTime = std::filesystem::last_write_time(path, error);
+        if (!error) {
+            source.Size = std::filesystem::file_size(path, error);
+        }
+
+        if (error)
+        {
+            SP_LOG_ERORR("ScriptingEngine::LoadScript - ({0}) can't be read ({1})", path, error.message());
+            return {};
+        }
+
+        auto it = m_Chunks.find(path);
+        if (it != m_Chunks.end() && it->second.ModifiedTime == source.ModifiedTime && it->second.Size == source.Size)
+        {
+            m_Stats.Hits++;
+            return it->second.Chunk;
+        }
+
+        source.Chunk = LoadBytecode(lua, path, source);
+        if (source.Chunk.valid())
+        {
+            m_Stats.BytecodeLoaded++;
+        }
+        else
+        {
+            auto loadedResult = lua.load_file(path);
+            if (!loadedResult.valid())
+            {
+                sol::error loadError = loadedResult;
+                SP_LOG_ERORR("ScriptingEngine::LoadScript - ({0})", loadError.what());
+                return {};
+            }
+
+            source.Chunk = loadedResult.get<sol::protected_function>();
+            m_Stats.Compiled++;
+
+            SP_LOG_INFO("ScriptingEngine::LoadScript - ({0}) compiled", path);
+            SaveBytecode(source.Chunk, path, source);
+        }
+
+        m_Chunks[path] = source;
+        return source.Chunk;
+    }
+
+    void ScriptCache::Clear()
+    {
+        m_Chunks.clear();
+        m_Stats = {};
+    }
+
+    bool ScriptCache::IsStale(const std::string& path) const
+    {
+        auto it = m_Chunks.find(path);
+        if (it == m_Chunks.end()) {
+            return false;
+        }
+
+        // a file that is being written can't be read for a moment, the loaded chunk is kept until it can
+        std::error_code error;
+        const auto modifiedTime = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return false;
+        }
+        const uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+
+        return it->second.ModifiedTime != modifiedTime || it->second.Size != size;
+    }
+
+    void ScriptCache::SetBytecodeDirectory(const std::string& directory)
+    {
+        s_BytecodeDirectory = directory;
+    }
+
+    const std::string& ScriptCache::GetBytecodeDirectory()
+    {
+        return s_BytecodeDirectory;
+    }
+
+    sol::protected_function ScriptCache::LoadBytecode(sol::state& lua, const std::string& path, const Entry& source) const
+    {
+        if (s_BytecodeDirectory.empty()) {
+            return {};
+        }
+
+        std::ifstream file(GetBytecodePath(path), std::ios::binary);
+        if (!file) {
+            return {};
+        }
+
+        BytecodeHeader header;
+        BytecodeHeader expected;
+        file.read((char*)&header, sizeof(header));
+
+        // stale or foreign files are ignored, the script is then compiled and the file overwritten
+        if (!file || std::memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) != 0 || header.Version != expected.Version
+            || header.ModifiedTime != (int64_t)source.ModifiedTime.time_since_epoch().count() || header.Size != source.Size
+            || header.PathLength != path.size()) {
+            return {};
+        }
+
+        std::string storedPath(header.PathLength, '\0');
+        file.read(storedPath.data(), storedPath.size());
+        if (!file || storedPath != path) {
+            return {};
+        }
+
+        const std::string bytecode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // binary only, lua rejects bytecode of another lua version or number format
+        auto loadedResult = lua.load_buffer(bytecode.data(), bytecode.size(), "@" + path, sol::load_mode::binary);
+        if (!loadedResult.valid()) {
+            return {};
+        }
+
+        return loadedResult.get<sol::protected_function>();
+    }
+
+    void ScriptCache::SaveBytecode(const sol::protected_function& chunk, const std::string& path, const Entry& source) const
+    {
+        if (s_BytecodeDirectory.empty()) {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(s_BytecodeDirectory, error);
+        if (error)
+        {
+            SP_LOG_WARN("ScriptingEngine::LoadScript - bytecode cache ({0}) can't be created ({1})", s_BytecodeDirectory, error.message());
+            return;
+        }
+
+        // debug info is kept, errors still report the script path and line
+        const sol::bytecode bytecode = chunk.dump();
+        const std::string_view data = bytecode.as_string_view();
+
+        BytecodeHeader header;
+        header.ModifiedTime = (int64_t)source.ModifiedTime.time_since_epoch().count();
+        header.Size = source.Size;
+        header.PathLength = (uint32_t)path.size();
+
+        // written next to the final file and renamed, a reader never sees a half written file
+        const std::filesystem::path target = GetBytecodePath(path);
+        std::filesystem::path temporary = target;
+        temporary += ".tmp";
+
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write((const char*)&header, sizeof(header));
+            file.write(path.data(), path.size());
+            file.write(data.data(), data.size());
+
+            if (!file)
+            {
+                SP_LOG_WARN("ScriptingEngine::LoadScript - bytecode of ({0}) can't be written", path);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporary, target, error);
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  ScriptCache.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "sol.hpp"
+
+#include <filesystem>
+#include <unordered_map>
+
+namespace Spectral {
+
+    // Compiled script chunks of one lua state, keyed by path: a file is only compiled again when its modification time or
+    // size changes, every call of the cached chunk still returns a fresh script table. Chunks compiled from source are also
+    // dumped to the bytecode cache on disk, so a cold start loads the bytecode instead of parsing the script.
+    class ScriptCache
+    {
+    public:
+        struct Stats
+        {
+            uint32_t Hits = 0;           // chunk was already loaded in this state
+            uint32_t Compiled = 0;       // parsed from source
+            uint32_t BytecodeLoaded = 0; // loaded from the bytecode cache on disk
+        };
+
+    public:
+        // invalid function when the file can't be loaded, the error is logged
+        sol::protected_function Load(sol::state& lua, const std::string& path);
+        void Clear();
+
+        // the file was modified since it was loaded in this state, false for files that were never loaded or can't be read
+        bool IsStale(const std::string& path) const;
+
+        const Stats& GetStats() const { return m_Stats; }
+
+        // shared by all states, an empty directory disables the bytecode cache (the in memory cache is always used)
+        static void SetBytecodeDirectory(const std::string& directory);
+        static const std::string& GetBytecodeDirectory();
+
+    private:
+        struct Entry
+        {
+            sol::protected_function Chunk;
+            std::filesystem::file_time_type ModifiedTime;
+            uintmax_t Size = 0;
+        };
+
+        sol::protected_function LoadBytecode(sol::state& lua, const std::string& path, const Entry& source) const;
+        void SaveBytecode(const sol::protected_function& chunk, const std::string& path, const Entry& source) const;
+
+    private:
+        std::unordered_map<std::string, Entry> m_Chunks;
+        Stats m_Stats;
+    };
+}
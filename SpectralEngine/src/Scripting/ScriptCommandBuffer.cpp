@@ -0,0 +1,79 @@
+//
+//  ScriptCommandBuffer.cpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+
+#include "ScriptCommandBuffer.hpp"
+
+#include "lua.hpp"
+#include "box2d/box2d.h"
+
+namespace Spectral {
+
+    ScriptCommandBuffer* ScriptCommandBuffer::Get(lua_State* state)
+    {
+        // stored in the extra space of the state, coroutines get a copy of it
+        return *static_cast<ScriptCommandBuffer**>(lua_getextraspace(state));
+    }
+
+    void ScriptCommandBuffer::Bind(lua_State* state, ScriptCommandBuffer* buffer)
+    {
+        *static_cast<ScriptCommandBuffer**>(lua_getextraspace(state)) = buffer;
+    }
+
+    void ScriptCommandBuffer::Remove(Entity entity, void (*remove)(Entity& entity))
+    {
+        m_Removals.push_back({entity, remove});
+    }
+
+    void ScriptCommandBuffer::ApplyImpulse2D(void* body, const Vector2& impulse, const Vector2& point, bool wake)
+    {
+        m_Impulses2D.push_back({body, impulse, point, wake});
+    }
+
+    void ScriptCommandBuffer::Flush()
+    {
+        // removals last, the staged writes and physics calls still find their components
+        uint32_t conflicts = 0;
+        for (auto& [type, pool] : m_Pools) {
+            conflicts += pool->Apply(m_Generation);
+        }
+        
+        if (conflicts > 0 && !m_ConflictReported)
+        {
+            SP_LOG_WARN("ScriptCommandBuffer::Flush - {0} component field(s) were also changed by a script of another worker state, the last flushed value is kept", conflicts);
+            m_ConflictReported = true;
+        }
+
+        for (const ImpulseCommand2D& command : m_Impulses2D) {
+            ((b2Body*)command.Body)->ApplyLinearImpulse(b2Vec2(command.Impulse.x, command.Impulse.y), b2Vec2(command.Point.x, command.Point.y), command.Wake);
+        }
+        m_Impulses2D.clear();
+
+        for (RemoveCommand& command : m_Removals) {
+            command.Remove(command.Target);
+        }
+        m_Removals.clear();
+        
+        // the copies are kept, they are reloaded by the next Sync() or Stage()
+        m_Generation++;
+    }
+
+    void ScriptCommandBuffer::Sync()
+    {
+        for (auto& [type, pool] : m_Pools) {
+            pool->Sync(m_Generation);
+        }
+    }
+
+    void ScriptCommandBuffer::Reset()
+    {
+        m_Pools.clear();
+        m_Impulses2D.clear();
+        m_Removals.clear();
+        m_Generation++;
+        m_ConflictReported = false;
+    }
+}
@@ -0,0 +1,179 @@
+//
+//  ScriptCommandBuffer.hpp
+//  SpectralEngine
+//
+//  Created by Nicolas U on 17.10.26.
+//
+#pragma once
+
+#include "pch.h"
+
+#include "raylib.h"
+#include "entt.hpp"
+
+#include "Entt/Entity.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+struct lua_State; // fwd declaration
+
+namespace Spectral {
+
+    // Deferred component writes of the scripts running on a worker lua state (see ScriptingEngine::OnUpdateParallel).
+    // entity:get() hands out a staged copy of the component instead of the component itself, Flush() writes back the copies
+    // the scripts changed. Physics calls and component removals are recorded and executed by Flush() too.
+    // The staged copies live until Reset(), a script can keep the reference it got (e.g. self.transform) across frames:
+    // Sync() reloads every copy from its component before the next parallel update.
+    // @NOTE: one buffer per worker state, so recording needs no locking. Only the 4 byte words a script changed are written
+    // back, two workers can change different fields of the same component. When both change the same field the worker
+    // flushed last wins, Flush() warns about it
+    class ScriptCommandBuffer
+    {
+    public:
+        // buffer bound to the lua state, nullptr for the main state (its scripts access the components directly)
+        static ScriptCommandBuffer* Get(lua_State* state);
+        static void Bind(lua_State* state, ScriptCommandBuffer* buffer);
+
+        // staging the same component twice returns the same copy, it is reloaded when it was staged before the last flush
+        template <typename T>
+        T& Stage(Entity entity);
+
+        void Remove(Entity entity, void (*remove)(Entity& entity));
+        void ApplyImpulse2D(void* body, const Vector2& impulse, const Vector2& point, bool wake);
+
+        // executes everything that was recorded, main thread only
+        void Flush();
+        
+        // reloads the staged copies from the components (before the jobs of a parallel update), main thread only
+        void Sync();
+        
+        // releases the staged copies, lua must not use a component reference of the worker state anymore (runtime end)
+        void Reset();
+
+    private:
+        struct StagedPoolBase
+        {
+            virtual ~StagedPoolBase() = default;
+            virtual uint32_t Apply(uint32_t generation) = 0; // returns the fields another buffer changed as well
+            virtual void Sync(uint32_t generation) = 0;
+        };
+
+        template <typename T>
+        struct StagedPool : StagedPoolBase
+        {
+            struct Staged
+            {
+                Entity Target;
+                T Original; // compared bytewise on the flush, only the changed words are written back
+                T Value;
+                uint32_t Generation = 0; // flush the copy was loaded for, older copies are neither applied nor trusted
+            };
+
+            // stable addresses and never erased before Reset(), lua holds references to the values
+            std::deque<Staged> Components;
+            std::unordered_map<entt::entity, size_t> Lookup;
+
+            uint32_t Apply(uint32_t generation) override
+            {
+                uint32_t conflicts = 0;
+                for (Staged& staged : Components)
+                {
+                    if (staged.Generation == generation && std::memcmp(&staged.Original, &staged.Value, sizeof(T)) != 0
+                        && staged.Target.template HasComponent<T>()) {
+                        conflicts += Write(staged, staged.Target.template GetComponent<T>());
+                    }
+                }
+                return conflicts;
+            }
+
+            static uint32_t Write(const Staged& staged, T& component)
+            {
+                const unsigned char* original = reinterpret_cast<const unsigned char*>(&staged.Original);
+                const unsigned char* value = reinterpret_cast<const unsigned char*>(&staged.Value);
+                unsigned char* target = reinterpret_cast<unsigned char*>(&component);
+
+                // word by word (the fields are floats and ints), a component that no longer matches the original in a
+                // word the script changed was written by another buffer since it was loaded
+                uint32_t conflicts = 0;
+                for (size_t offset = 0; offset < sizeof(T); offset += sizeof(uint32_t))
+                {
+                    const size_t size = std::min(sizeof(uint32_t), sizeof(T) - offset);
+                    if (std::memcmp(value + offset, original + offset, size) == 0) {
+                        continue;
+                    }
+
+                    conflicts += std::memcmp(target + offset, original + offset, size) != 0;
+                    std::memcpy(target + offset, value + offset, size);
+                }
+                return conflicts;
+            }
+
+            void Sync(uint32_t generation) override
+            {
+                // copies of removed components (or entities) keep their last values, they are never applied again
+                for (Staged& staged : Components)
+                {
+                    if (staged.Target.template HasComponent<T>()) {
+                        Load(staged, generation);
+                    }
+                }
+            }
+
+            static void Load(Staged& staged, uint32_t generation)
+            {
+                // bytewise copies, so the padding of Original and Value is identical for the compare
+                std::memcpy(&staged.Original, &staged.Target.template GetComponent<T>(), sizeof(T));
+                std::memcpy(&staged.Value, &staged.Original, sizeof(T));
+                staged.Generation = generation;
+            }
+        };
+
+        struct RemoveCommand
+        {
+            Entity Target;
+            void (*Remove)(Entity& entity) = nullptr;
+        };
+
+        struct ImpulseCommand2D
+        {
+            void* Body = nullptr; // b2Body
+            Vector2 Impulse = {0.0f, 0.0f};
+            Vector2 Point = {0.0f, 0.0f};
+            bool Wake = true;
+        };
+
+        std::unordered_map<entt::id_type, std::unique_ptr<StagedPoolBase>> m_Pools;
+        std::vector<ImpulseCommand2D> m_Impulses2D;
+        std::vector<RemoveCommand> m_Removals;
+        uint32_t m_Generation = 1; // incremented by every flush
+        bool m_ConflictReported = false; // once until Reset()
+    };
+
+    template <typename T>
+    T& ScriptCommandBuffer::Stage(Entity entity)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable components can be staged");
+
+        auto& pool = m_Pools[entt::type_hash<T>::value()];
+        if (!pool) {
+            pool = std::make_unique<StagedPool<T>>();
+        }
+        auto& staged = static_cast<StagedPool<T>&>(*pool);
+
+        const auto [it, inserted] = staged.Lookup.try_emplace((entt::entity)entity, staged.Components.size());
+        if (inserted) {
+            staged.Components.emplace_back().Target = entity;
+        }
+
+        auto& copy = staged.Components[it->second];
+        if (copy.Generation != m_Generation) {
+            StagedPool<T>::Load(copy, m_Generation);
+        }
+        return copy.Value;
+    }
+}
@@ -10,8 +10,11 @@
 #include "raylib.h"
 #include "box2d/box2d.h"
 #include "MetaHelper.hpp"
+#include "ScriptCommandBuffer.hpp"
+#include "ScriptBatch.hpp"
 #include "Entt/Entity.hpp"
 #include "Entt/Components.hpp"
+#include "Physics/PhysicsQuery.hpp"
 
 
 namespace Spectral {
@@ -19,8 +22,13 @@ namespace Spectral {
     // wrap the static functions inside an unnamed namespace to limits their scope to the file in which they are declared
     namespace {
         template <typename T>
-        static auto Entity_GetComponent(Entity* entity, sol::this_state s)  // entity needs to be passed by pointer
+        static sol::reference Entity_GetComponent(Entity* entity, sol::this_state s)  // entity needs to be passed by pointer
         {
+            // worker states (parallel scripts) get a staged copy, it is written back after the parallel update
+            if (ScriptCommandBuffer* commands = ScriptCommandBuffer::Get(s)) {
+                return sol::make_reference(s, std::ref(commands->Stage<T>(*entity)));
+            }
+            
             auto& component = entity->GetComponent<T>();
             return sol::make_reference(s, std::ref(component));
         }
@@ -32,10 +40,32 @@ namespace Spectral {
         }
         
         template <typename T>
-        static bool Entity_RemoveComponent(Entity* entity) {
+        static bool Entity_RemoveComponent(Entity* entity, sol::this_state s) {
+            if (ScriptCommandBuffer* commands = ScriptCommandBuffer::Get(s))
+            {
+                if (!entity->HasComponent<T>()) {
+                    return false;
+                }
+                
+                commands->Remove(*entity, [](Entity& target) { target.RemoveComponent<T>(); });
+                return true;
+            }
+            
             return entity->RemoveComponent<T>();
         }
         
+        // the has/get/remove functions of a component type, a call from lua is a plain function pointer call instead of a
+        // meta lookup and an invoke through entt::meta_any
+        struct ComponentFunctions
+        {
+            bool (*Has)(Entity*) = nullptr;
+            sol::reference (*Get)(Entity*, sol::this_state) = nullptr;
+            bool (*Remove)(Entity*, sol::this_state) = nullptr;
+        };
+        
+        // filled by RegisterMetaFunctions before any lua state exists, read only afterwards (shared by the worker states)
+        static std::unordered_map<entt::id_type, ComponentFunctions> s_ComponentFunctions;
+        
         template <typename T>
         static void RegisterMetaComponent()
         {
@@ -46,19 +76,244 @@ namespace Spectral {
                 .template func<&Entity_GetComponent<T>>("get"_hs)
                 .template func<&Entity_RemoveComponent<T>>("remove"_hs)
             ;
+            
+            // keyed like the type_id exposed to lua (see RegisterComponents)
+            s_ComponentFunctions[entt::type_hash<T>::value()] = {&Entity_HasComponent<T>, &Entity_GetComponent<T>, &Entity_RemoveComponent<T>};
+        }
+        
+        // registry key of the per state table that maps a component usertype table (e.g. Transform) to its functions
+        static const char s_ComponentCacheKey = 0;
+        
+        static void CreateComponentCache(lua_State* L)
+        {
+            lua_newtable(L);
+            
+            // weak keys, a table passed by mistake doesn't stay alive because of the cache
+            lua_newtable(L);
+            lua_pushliteral(L, "k");
+            lua_setfield(L, -2, "__mode");
+            lua_setmetatable(L, -2);
+            
+            lua_rawsetp(L, LUA_REGISTRYINDEX, &s_ComponentCacheKey);
+        }
+        
+        static const ComponentFunctions* FindComponentFunctions(entt::id_type id)
+        {
+            auto it = s_ComponentFunctions.find(id);
+            return it != s_ComponentFunctions.end() ? &it->second : nullptr;
+        }
+        
+        // entity:get(Transform) or entity:get(Transform.type_id()), the type_id of a usertype table is only called the first
+        // time the table is used on a state, afterwards the functions are a raw table lookup away
+        static const ComponentFunctions* ResolveComponent(const sol::object& typeOrId, sol::this_state s)
+        {
+            if (typeOrId.get_type() != sol::type::table) {
+                return FindComponentFunctions(deduce_type(typeOrId));
+            }
+            
+            lua_State* L = s;
+            lua_rawgetp(L, LUA_REGISTRYINDEX, &s_ComponentCacheKey);
+            typeOrId.push(L);
+            lua_rawget(L, -2);
+            
+            const ComponentFunctions* functions = (const ComponentFunctions*)lua_touserdata(L, -1);
+            lua_pop(L, 1);
+            
+            if (!functions)
+            {
+                functions = FindComponentFunctions(get_type_id(typeOrId.as<sol::table>()));
+                
+                if (functions)
+                {
+                    typeOrId.push(L);
+                    lua_pushlightuserdata(L, (void*)functions);
+                    lua_rawset(L, -3);
+                }
+            }
+            
+            lua_pop(L, 1); // cache table
+            return functions;
         }
     
     
-        static void Physics_ApplyImpulse(RigidBody2DComponent& self, const Vector2& impulse, const Vector2& point, bool wake)
+        // transform.rotation as euler angles, every read and write goes through the quaternion of the component so a
+        // component wise write like `transform.rotation.z = angle` still rotates the entity
+        struct EulerAnglesProxy
+        {
+            TransformComponent* Transform = nullptr;
+            
+            Vector3 Get() const { return Transform->GetEulerAngles(); }
+            float GetX() const { return Get().x; }
+            float GetY() const { return Get().y; }
+            float GetZ() const { return Get().z; }
+            
+            void SetX(float x) { Vector3 angles = Get(); angles.x = x; Transform->SetEulerAngles(angles); }
+            void SetY(float y) { Vector3 angles = Get(); angles.y = y; Transform->SetEulerAngles(angles); }
+            void SetZ(float z) { Vector3 angles = Get(); angles.z = z; Transform->SetEulerAngles(angles); }
+        };
+        
+        static EulerAnglesProxy Transform_GetRotation(TransformComponent& self)
+        {
+            return {&self};
+        }
+        
+        // a vector3 or another transform's rotation
+        static void Transform_SetRotation(TransformComponent& self, const sol::object& angles)
+        {
+            if (angles.is<Vector3>()) {
+                self.SetEulerAngles(angles.as<Vector3>());
+            } else if (angles.is<EulerAnglesProxy>()) {
+                self.SetEulerAngles(angles.as<EulerAnglesProxy>().Get());
+            } else {
+                SP_LOG_WARN("Transform.rotation: expects a vector3");
+            }
+        }
+        
+        static void Transform_SetRotationAngles(TransformComponent& self, float x, float y, float z)
+        {
+            self.SetEulerAngles({x, y, z});
+        }
+        
+        static void Physics_ApplyImpulse(RigidBody2DComponent& self, const Vector2& impulse, const Vector2& point, bool wake, sol::this_state s)
         {
             b2Body* body = (b2Body*)self.RuntimeBody;
             
-            if (body->GetType() == b2_dynamicBody) {
+            if (body->GetType() == b2_dynamicBody)
+            {
+                // the Box2D world is not thread safe, worker states record the impulse instead
+                if (ScriptCommandBuffer* commands = ScriptCommandBuffer::Get(s)) {
+                    commands->ApplyImpulse2D(body, impulse, point, wake);
+                } else {
                     body->ApplyLinearImpulse(b2Vec2(impulse.x, impulse.y), b2Vec2(point.x, point.y), wake);
+                }
             } else {
                 SP_LOG_WARN("Physics_ApplyImpulse: Attempting to apply impulse to a non-dynamic body");
             }
         }
+        
+        // physics queries, results are returned as lua tables (nil when nothing is hit)
+        static QueryFilter Physics_MakeFilter(const sol::optional<Entity>& ignore)
+        {
+            QueryFilter filter;
+            if (ignore) {
+                filter.Ignore = (entt::entity)ignore.value();
+            }
+            return filter;
+        }
+        
+        static sol::object Physics_MakeHit(const PhysicsQuery& self, const RaycastHit& hit, sol::this_state s)
+        {
+            if (!hit.Hit) {
+                return sol::lua_nil;
+            }
+            
+            sol::state_view lua(s);
+            sol::table result = lua.create_table();
+            result["entity"] = Entity(hit.Entity, self.GetScene());
+            result["point"] = hit.Point;
+            result["normal"] = hit.Normal;
+            result["distance"] = hit.Distance;
+            return result;
+        }
+        
+        static sol::object Physics_Raycast(const PhysicsQuery& self, const Vector3& origin, const Vector3& direction, float maxDistance, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            RaycastHit hit;
+            self.Raycast({origin, direction, maxDistance, Physics_MakeFilter(ignore)}, hit);
+            return Physics_MakeHit(self, hit, s);
+        }
+        
+        static sol::object Physics_SphereCast(const PhysicsQuery& self, const Vector3& origin, const Vector3& direction, float maxDistance, float radius, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            RaycastHit hit;
+            self.SphereCast({origin, direction, maxDistance, radius, Physics_MakeFilter(ignore)}, hit);
+            return Physics_MakeHit(self, hit, s);
+        }
+        
+        static bool Physics_Linecast(const PhysicsQuery& self, const Vector3& from, const Vector3& to, sol::optional<Entity> ignore)
+        {
+            return self.Linecast({from, to, Physics_MakeFilter(ignore)});
+        }
+        
+        static sol::table Physics_OverlapSphere(const PhysicsQuery& self, const Vector3& center, float radius, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            std::vector<entt::entity> entities;
+            self.OverlapSphere(center, radius, entities, Physics_MakeFilter(ignore));
+            
+            sol::state_view lua(s);
+            sol::table result = lua.create_table((int)entities.size(), 0);
+            for (size_t i = 0; i < entities.size(); i++) {
+                result[i + 1] = Entity(entities[i], self.GetScene());
+            }
+            return result;
+        }
+        
+        static sol::object Physics_Raycast2D(const PhysicsQuery& self, const Vector2& from, const Vector2& to, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            RaycastHit2D hit;
+            if (!self.Raycast2D({from, to, Physics_MakeFilter(ignore)}, hit)) {
+                return sol::lua_nil;
+            }
+            
+            sol::state_view lua(s);
+            sol::table result = lua.create_table();
+            result["entity"] = Entity(hit.Entity, self.GetScene());
+            result["point"] = hit.Point;
+            result["normal"] = hit.Normal;
+            result["fraction"] = hit.Fraction;
+            return result;
+        }
+        
+        // queries = { {origin = vector3, direction = vector3, maxDistance = number}, ... }, returns one hit (or false) per query
+        static sol::table Physics_RaycastBatch(const PhysicsQuery& self, const sol::table& queries, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            const QueryFilter filter = Physics_MakeFilter(ignore);
+            
+            std::vector<RaycastQuery> batch(queries.size());
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                const sol::table query = queries[i + 1];
+                batch[i] = {query.get<Vector3>("origin"), query.get<Vector3>("direction"), query.get_or("maxDistance", 1000.0f), filter};
+            }
+            
+            std::vector<RaycastHit> hits(batch.size());
+            self.RaycastBatch(batch.data(), hits.data(), batch.size());
+            
+            sol::state_view lua(s);
+            sol::table result = lua.create_table((int)hits.size(), 0);
+            for (size_t i = 0; i < hits.size(); i++)
+            {
+                if (hits[i].Hit) {
+                    result[i + 1] = Physics_MakeHit(self, hits[i], s);
+                } else {
+                    result[i + 1] = false; // keeps the table a sequence
+                }
+            }
+            return result;
+        }
+        
+        // queries = { {from = vector3, to = vector3}, ... }, returns true for every blocked line
+        static sol::table Physics_LinecastBatch(const PhysicsQuery& self, const sol::table& queries, sol::optional<Entity> ignore, sol::this_state s)
+        {
+            const QueryFilter filter = Physics_MakeFilter(ignore);
+            
+            std::vector<LinecastQuery> batch(queries.size());
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                const sol::table query = queries[i + 1];
+                batch[i] = {query.get<Vector3>("from"), query.get<Vector3>("to"), filter};
+            }
+            
+            std::vector<uint8_t> blocked(batch.size());
+            self.LinecastBatch(batch.data(), blocked.data(), batch.size());
+            
+            sol::state_view lua(s);
+            sol::table result = lua.create_table((int)blocked.size(), 0);
+            for (size_t i = 0; i < blocked.size(); i++) {
+                result[i + 1] = blocked[i] != 0;
+            }
+            return result;
+        }
     }
     
     void ScriptGlue::RegisterMetaFunctions()
@@ -66,18 +321,29 @@ namespace Spectral {
         // register all component types
         RegisterMetaComponent<TransformComponent>();
         RegisterMetaComponent<RigidBody2DComponent>();
-        // add additional components here as needed
+        // add additional components here as needed (and a typed getter to the Entity usertype in RegisterFunctions)
     }
     
     
     void ScriptGlue::RegisterComponents(sol::state& lua)
     {
+        lua.new_usertype<EulerAnglesProxy>(
+                "EulerAngles",
+                sol::no_constructor,
+                "x", sol::property(&EulerAnglesProxy::GetX, &EulerAnglesProxy::SetX),
+                "y", sol::property(&EulerAnglesProxy::GetY, &EulerAnglesProxy::SetY),
+                "z", sol::property(&EulerAnglesProxy::GetZ, &EulerAnglesProxy::SetZ),
+                "toVector3", &EulerAnglesProxy::Get
+                );
+        
         lua.new_usertype<TransformComponent>(
                 "Transform",
                 sol::constructors<TransformComponent()>(),
                 "type_id", &entt::type_hash<TransformComponent>::value, // expose type_id to LUA
                 "translation", &TransformComponent::Translation,
-                "rotation", &TransformComponent::Rotation,
+                "rotation", sol::property(&Transform_GetRotation, &Transform_SetRotation), // euler angles, writable per component
+                "setRotation", &Transform_SetRotationAngles,
+                "quaternion", &TransformComponent::Rotation,
                 "scale", &TransformComponent::Scale
                 );
         
@@ -94,36 +360,36 @@ namespace Spectral {
 
     void ScriptGlue::RegisterFunctions(sol::state& lua)
     {
-        using namespace entt::literals;
-        
         // register the Entity class and its methods (e.g. has, get, remove) with sol so that Lua can call these methods on an entity object
         lua.new_usertype<Entity>(
                 "Entity",
                 sol::constructors<Entity()>(),
                                  
-                "has", [](Entity &self, const sol::object &type_or_id) {
-                        const auto maybe_any =
-                        invoke_meta_func(deduce_type(type_or_id), "has"_hs, &self);
-                    
-                        return maybe_any ? maybe_any.cast<bool>() : false;
-                        },
-                                 
-                "get", [](Entity &self, const sol::object &type_or_id, sol::this_state s) {
-                    const auto maybe_any =
-                    invoke_meta_func(deduce_type(type_or_id), "get"_hs, &self, s);
-                    
-                    return maybe_any ? maybe_any.cast<sol::reference>() : sol::lua_nil_t{};
+                "has", [](Entity &self, const sol::object &type_or_id, sol::this_state s) {
+                    const ComponentFunctions* functions = ResolveComponent(type_or_id, s);
+                    return functions && functions->Has ? functions->Has(&self) : false;
                 },
                                  
-                "remove", [](Entity &self, const sol::object &type_or_id) {
-                    const auto maybe_any =
-                    invoke_meta_func(deduce_type(type_or_id), "remove"_hs, &self);
-                    
-                    return maybe_any? maybe_any.cast<bool>() : false;
-                }
+                "get", [](Entity &self, const sol::object &type_or_id, sol::this_state s) -> sol::object {
+                    const ComponentFunctions* functions = ResolveComponent(type_or_id, s);
+                    if (functions && functions->Get) {
+                        return functions->Get(&self, s);
+                    }
+                    return sol::lua_nil;
+                },
                                  
+                "remove", [](Entity &self, const sol::object &type_or_id, sol::this_state s) {
+                    const ComponentFunctions* functions = ResolveComponent(type_or_id, s);
+                    return functions && functions->Remove ? functions->Remove(&self, s) : false;
+                },
+                
+                // typed getters, no type deduction at all (e.g. entity:transform())
+                "transform", &Entity_GetComponent<TransformComponent>,
+                "rigidBody2D", &Entity_GetComponent<RigidBody2DComponent>
                 );
         
+        CreateComponentCache(lua);
+        
         // math
         lua.new_usertype<Vector2>(
             "vector2",
@@ -142,10 +408,37 @@ namespace Spectral {
                 return (Vector2){x, y};
             });
         
-        lua.set_function("vector3", [](float x, float y) {
-                return (Vector2){x, y};
+        lua.set_function("vector3", [](float x, float y, float z) {
+                return (Vector3){x, y, z};
             });
         
+        // entities of one script type, the first argument of OnUpdateAll(entities, ts)
+        lua.new_usertype<ScriptBatch>(
+            "ScriptBatch",
+            sol::no_constructor,
+            "count", sol::readonly_property(&ScriptBatch::GetCount),
+            sol::meta_function::length, &ScriptBatch::GetCount,
+            "entity", &ScriptBatch::GetEntity,
+            "instance", &ScriptBatch::GetInstance,
+            "transform", &ScriptBatch::GetTransform,
+            "rigidBody2D", &ScriptBatch::GetRigidBody2D,
+            "getPosition", &ScriptBatch::GetPosition,
+            "setPosition", &ScriptBatch::SetPosition
+        );
+        
+        // physics queries of the running scene, available as the global "physics" (see ScriptingEngine::SetPhysicsQuery)
+        lua.new_usertype<PhysicsQuery>(
+            "PhysicsQuery",
+            sol::no_constructor,
+            "raycast", &Physics_Raycast,
+            "sphereCast", &Physics_SphereCast,
+            "linecast", &Physics_Linecast,
+            "overlapSphere", &Physics_OverlapSphere,
+            "raycast2d", &Physics_Raycast2D,
+            "raycastBatch", &Physics_RaycastBatch,
+            "linecastBatch", &Physics_LinecastBatch
+        );
+        
         // input functions
         lua.set_function("inputKeyPressed", IsKeyPressed);
         lua.set_function("inputKeyDown", IsKeyDown);
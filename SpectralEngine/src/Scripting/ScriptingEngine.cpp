@@ -9,12 +9,48 @@
 
 #include "lua.hpp"
 #include "ScriptGlue.hpp"
+#include "ScriptCommandBuffer.hpp"
+#include "ScriptBatch.hpp"
+#include "Core/JobSystem.hpp"
+#include "Physics/PhysicsQuery.hpp"
 
+#include <chrono>
 #include <filesystem>
 
 namespace Spectral {
 
     static sol::state s_LuaState;
+    static ScriptCache s_ScriptCache; // chunks of s_LuaState
+
+    // collector state of a lua state (see CollectGarbage)
+    struct ScriptGC
+    {
+        size_t BaseHeap = 0;     // heap after the last completed cycle (major collection in generational mode)
+        size_t MinorHeap = 0;    // heap after the last young collection (generational mode)
+        bool Collecting = false; // an incremental cycle is running
+    };
+
+    static ScriptGC s_LuaGC; // of s_LuaState
+
+    // lua state of the parallel scripts, a script instance always stays on the worker it was created on
+    struct ScriptWorker
+    {
+        sol::state Lua;
+        ScriptCache Cache;
+        ScriptCommandBuffer Commands;
+        ScriptGC GC;
+    };
+
+    static std::vector<std::unique_ptr<ScriptWorker>> s_Workers;
+    static uint32_t s_NextWorker = 0; // parallel scripts are spread round robin over the workers
+    static PhysicsQuery* s_PhysicsQuery = nullptr;
+
+    // system style scripts (OnUpdateAll), one batch per script path
+    static std::unordered_map<std::string, int32_t> s_BatchIds;
+    static std::vector<ScriptBatch> s_Batches;
+
+    static ScriptingEngine::GCSettings s_GCSettings;
+    static ScriptingEngine::GCStats s_GCStats;
 
     // @TODO: Handle panic
     static void my_panic(sol::optional<std::string> maybe_msg) {
@@ -28,20 +64,171 @@ namespace Spectral {
         lua_close(s_LuaState);
     }
 
-    static sol::load_result LoadScript(const std::string& path)
+    // new instance of the script: runs the cached chunk of the file, an invalid table when loading or running it fails
+    static sol::table LoadScript(sol::state& lua, ScriptCache& cache, const std::string& path)
     {
-        auto loadedResult = s_LuaState.load_file(path);
+        sol::protected_function chunk = cache.Load(lua, path);
+        if (!chunk.valid()) {
+            return {};
+        }
         
-        if (!loadedResult.valid())
+        sol::protected_function_result result = chunk();
+        if (!result.valid())
         {
-            sol::error error = loadedResult;
+            sol::error error = result;
             SP_LOG_ERORR("ScriptingEngine::LoadScript - ({0})", error.what());
+            return {};
+        }
+        
+        if (result.get_type() != sol::type::table)
+        {
+            SP_LOG_ERORR("ScriptingEngine::LoadScript - ({0}) has to return its script table", path);
+            return {};
+        }
+        return result;
+    }
+
+    static void SetupState(sol::state& lua)
+    {
+        lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::package);
+        
+        ScriptGlue::RegisterFunctions(lua);
+        ScriptGlue::RegisterComponents(lua);
+        
+        // temporary path for packages, like keyboard_keys
+        std::string packagePath = "assets/lua_package/";
+        if (std::filesystem::exists(packagePath))
+        {
+            SP_LOG_INFO("ScriptingEngine::Init - package path ({0}) found", packagePath);
+            lua["package"]["path"] = lua["package"]["path"].get<std::string>() + ";" + packagePath + "?.lua";
+        }
+    }
+
+    static size_t GetHeapBytes(lua_State* L)
+    {
+        return (size_t)lua_gc(L, LUA_GCCOUNT) * 1024 + (size_t)lua_gc(L, LUA_GCCOUNTB);
+    }
+
+    static void ApplyGCMode(lua_State* L, ScriptGC& gc)
+    {
+        if (s_GCSettings.Mode == ScriptingEngine::GCMode::Generational) {
+            lua_gc(L, LUA_GCGEN, 0, 0);
+        } else {
+            // the step size is a power of 2 for lua, it bounds the work (and so the time) of one step
+            const int stepSize = s_GCSettings.Mode == ScriptingEngine::GCMode::Incremental ? (int)std::ceil(std::log2(std::max(s_GCSettings.StepSizeKB, 1u) * 1024.0)) : 0;
+            lua_gc(L, LUA_GCINC, 0, 0, stepSize);
+        }
+        
+        // the scheduled modes only collect in CollectGarbage(), never in the middle of a script
+        if (s_GCSettings.Mode == ScriptingEngine::GCMode::Automatic) {
+            lua_gc(L, LUA_GCRESTART);
+        } else {
+            lua_gc(L, LUA_GCSTOP);
+        }
+        
+        gc.BaseHeap = gc.MinorHeap = GetHeapBytes(L);
+        gc.Collecting = false;
+    }
+
+    static void StepGC(lua_State* L, ScriptGC& gc, ScriptingEngine::GCStats& stats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t heap = GetHeapBytes(L);
+        const bool overdue = heap > (size_t)((double)gc.BaseHeap * s_GCSettings.MaxHeapGrowth);
+        
+        if (s_GCSettings.Mode == ScriptingEngine::GCMode::Generational)
+        {
+            // a young collection only visits the objects created since the last one, the old ones are only collected by a
+            // major collection (a stopped lua state never starts one on its own)
+            if (overdue)
+            {
+                lua_gc(L, LUA_GCCOLLECT);
+                stats.Steps++;
+                stats.CompletedCycles++;
+                gc.BaseHeap = gc.MinorHeap = GetHeapBytes(L);
+            }
+            else if (heap > (size_t)((double)gc.MinorHeap * s_GCSettings.Pause))
+            {
+                lua_gc(L, LUA_GCSTEP, 0);
+                stats.Steps++;
+                gc.MinorHeap = GetHeapBytes(L);
+            }
+        }
+        else if (s_GCSettings.Mode == ScriptingEngine::GCMode::Incremental)
+        {
+            if (!gc.Collecting && heap > (size_t)((double)gc.BaseHeap * s_GCSettings.Pause)) {
+                gc.Collecting = true;
+            }
+            
+            // the budget grows with the heap past the pause threshold, a script that allocates faster than the budget collects
+            // is caught up over a few frames instead of by a whole cycle at once (MaxHeapGrowth)
+            // @NOTE: the budget is checked between the steps, a step can overshoot it (the atomic phase of a cycle and big
+            // tables like the registry are never split)
+            const double growth = (double)heap / std::max((double)gc.BaseHeap * s_GCSettings.Pause, 1.0);
+            const std::chrono::duration<double, std::milli> budget(s_GCSettings.BudgetMs * std::max(growth, 1.0));
+            
+            while (gc.Collecting && (overdue || std::chrono::steady_clock::now() - start < budget))
+            {
+                stats.Steps++;
+                if (lua_gc(L, LUA_GCSTEP, 0))
+                {
+                    stats.CompletedCycles++;
+                    gc.Collecting = false;
+                    gc.BaseHeap = GetHeapBytes(L);
+                }
+            }
         }
-        else
+        
+        stats.HeapBytes += GetHeapBytes(L);
+        stats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void CollectFull(lua_State* L, ScriptGC& gc, ScriptingEngine::GCStats& stats)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        
+        lua_gc(L, LUA_GCCOLLECT);
+        
+        gc.BaseHeap = gc.MinorHeap = GetHeapBytes(L);
+        gc.Collecting = false;
+        
+        stats.Steps++;
+        stats.CompletedCycles++;
+        stats.HeapBytes += gc.BaseHeap;
+        stats.TimeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void SetPhysicsGlobal(sol::state& lua, PhysicsQuery* query)
+    {
+        if (query) {
+            lua["physics"] = query;
+        } else {
+            lua["physics"] = sol::lua_nil;
+        }
+    }
+
+    static ScriptWorker& GetNextWorker(int32_t& index)
+    {
+        // created on first use, most scenes don't have parallel scripts
+        if (s_Workers.empty())
         {
-            SP_LOG_INFO("ScriptingEngine::LoadScript - Script loaded successfully");
+            const uint32_t count = JobSystem::GetThreadCount();
+            SP_LOG_INFO("ScriptingEngine - creating {0} worker lua states", count);
+            
+            for (uint32_t i = 0; i < count; i++)
+            {
+                auto worker = std::make_unique<ScriptWorker>();
+                SetupState(worker->Lua);
+                SetPhysicsGlobal(worker->Lua, s_PhysicsQuery);
+                ScriptCommandBuffer::Bind(worker->Lua, &worker->Commands);
+                ApplyGCMode(worker->Lua, worker->GC);
+                
+                s_Workers.push_back(std::move(worker));
+            }
         }
-        return loadedResult;
+        
+        index = (int32_t)(s_NextWorker++ % s_Workers.size());
+        return *s_Workers[index];
     }
 
     
@@ -52,18 +239,63 @@ namespace Spectral {
         ScriptGlue::RegisterMetaFunctions();
         
         s_LuaState = sol::state(sol::c_call<decltype(&my_panic), &my_panic>);
+        ScriptCommandBuffer::Bind(s_LuaState, nullptr); // the main state writes the components directly
         
-        s_LuaState.open_libraries(sol::lib::base, sol::lib::math, sol::lib::package);
+        SetupState(s_LuaState);
+        ApplyGCMode(s_LuaState, s_LuaGC);
+    }
+
+    void ScriptingEngine::SetPhysicsQuery(PhysicsQuery* query)
+    {
+        s_PhysicsQuery = query;
         
-        ScriptGlue::RegisterFunctions(s_LuaState);
-        ScriptGlue::RegisterComponents(s_LuaState);
+        SetPhysicsGlobal(s_LuaState, query);
+        for (auto& worker : s_Workers) {
+            SetPhysicsGlobal(worker->Lua, query);
+        }
+    }
+
+    uint32_t ScriptingEngine::GetWorkerCount()
+    {
+        return (uint32_t)s_Workers.size();
+    }
+
+    ScriptCache::Stats ScriptingEngine::GetScriptCacheStats()
+    {
+        ScriptCache::Stats stats = s_ScriptCache.GetStats();
         
-        // temporary path for packages, like keyboard_keys
-        std::string packagePath = "assets/lua_package/";
-        if (std::filesystem::exists(packagePath))
+        for (const auto& worker : s_Workers)
         {
-            SP_LOG_INFO("ScriptingEngine::Init - package path ({0}) found", packagePath);
-            s_LuaState["package"]["path"] = s_LuaState["package"]["path"].get<std::string>() + ";" + packagePath + "?.lua";
+            stats.Hits += worker->Cache.GetStats().Hits;
+            stats.Compiled += worker->Cache.GetStats().Compiled;
+            stats.BytecodeLoaded += worker->Cache.GetStats().BytecodeLoaded;
+        }
+        return stats;
+    }
+
+    // resolves the functions once, so an update is a single call through a registry reference (no table lookups)
+    static void ResolveFunctions(LuaScriptComponent& lsc)
+    {
+        lsc.CreateFunction = lsc.self["OnCreate"];
+        lsc.UpdateFunction = lsc.self["OnUpdate"];
+        lsc.DestroyFunction = lsc.self["OnDestroy"];
+        lsc.UpdateAllFunction = lsc.self["OnUpdateAll"];
+        
+        // anything else than a function (e.g. a typo assigning a number) is treated like a missing function
+        if (lsc.CreateFunction.get_type() != sol::type::function) { lsc.CreateFunction = sol::protected_function(); }
+        if (lsc.UpdateFunction.get_type() != sol::type::function) { lsc.UpdateFunction = sol::protected_function(); }
+        if (lsc.DestroyFunction.get_type() != sol::type::function) { lsc.DestroyFunction = sol::protected_function(); }
+        if (lsc.UpdateAllFunction.get_type() != sol::type::function) { lsc.UpdateAllFunction = sol::protected_function(); }
+        
+        // every instance of a script with OnUpdateAll joins the batch of its path
+        lsc.Batch = -1;
+        if (lsc.UpdateAllFunction.valid() && lsc.Worker < 0)
+        {
+            const auto [it, inserted] = s_BatchIds.try_emplace(lsc.ScriptPath, (int32_t)s_Batches.size());
+            if (inserted) {
+                s_Batches.emplace_back();
+            }
+            lsc.Batch = it->second;
         }
     }
 
@@ -73,24 +305,33 @@ namespace Spectral {
         
         if (!lsc.ScriptPath.empty())
         {
-            auto loaded_result = LoadScript(lsc.ScriptPath);
+            lsc.self = LoadScript(s_LuaState, s_ScriptCache, lsc.ScriptPath);
+            lsc.Worker = -1;
             
-            lsc.self = loaded_result.call();
+            if (!lsc.self.valid()) {
+                return; // logged by LoadScript
+            }
             
-            if (!lsc.self.valid())
+            // parallel safe scripts live on a worker state, the instance is created again over there
+            ScriptWorker* worker = nullptr;
+            if (lsc.self.get_or("Parallel", false))
             {
-                // @TODO: Log error
-                return;
+                worker = &GetNextWorker(lsc.Worker);
+                lsc.self = LoadScript(worker->Lua, worker->Cache, lsc.ScriptPath);
+                
+                if (!lsc.self.valid()) {
+                    return;
+                }
             }
             
-            lsc.self["owner"] = std::ref(entity); // make the owner entity available to lua
+            lsc.self["owner"] = entity; // make the owner entity available to lua, stored by value so it stays valid after this call
             
-            sol::protected_function create = lsc.self["OnCreate"];
+            ResolveFunctions(lsc);
             
-            if (create.valid())
+            if (lsc.CreateFunction.valid())
             {
                 // execute script function
-                sol::protected_function_result result = create(lsc.self);
+                sol::protected_function_result result = lsc.CreateFunction(lsc.self);
                 
                 if (!result.valid())
                 {
@@ -98,6 +339,10 @@ namespace Spectral {
                     SP_LOG_ERORR("ScriptingEngine::OnCreate - ({0})", error.what());
                 }
             }
+            
+            if (worker) {
+                worker->Commands.Flush();
+            }
         }
     }
 
@@ -105,23 +350,195 @@ namespace Spectral {
     {
         auto& lsc = entity.GetComponent<LuaScriptComponent>();
         
-        if (!lsc.ScriptPath.empty())
+        // @NOTE: the scene already skips scripts without OnUpdate, this only protects direct calls
+        if (lsc.UpdateFunction.valid())
+        {
+            // execute script function
+            sol::protected_function_result result = lsc.UpdateFunction(lsc.self, ts);
+            if (!result.valid())
+            {
+                sol::error error = result;
+                SP_LOG_ERORR("ScriptingEngine::OnUpdate - ({0})", error.what());
+            }
+        }
+    }
+
+    void ScriptingEngine::OnDestroy(Entity entity)
+    {
+        auto& lsc = entity.GetComponent<LuaScriptComponent>();
+        
+        if (lsc.DestroyFunction.valid())
+        {
+            sol::protected_function_result result = lsc.DestroyFunction(lsc.self);
+            if (!result.valid())
+            {
+                sol::error error = result;
+                SP_LOG_ERORR("ScriptingEngine::OnDestroy - ({0})", error.what());
+            }
+        }
+        
+        // worker states of parallel scripts record their writes, OnDestroy runs on the main thread so they are applied right away
+        if (lsc.Worker >= 0) {
+            s_Workers[lsc.Worker]->Commands.Flush();
+        }
+        
+        lsc.CreateFunction = sol::protected_function();
+        lsc.UpdateFunction = sol::protected_function();
+        lsc.DestroyFunction = sol::protected_function();
+        lsc.UpdateAllFunction = sol::protected_function();
+        lsc.Batch = -1;
+        lsc.self = sol::table();
+    }
+
+    bool ScriptingEngine::ReloadScript(Entity entity)
+    {
+        auto& lsc = entity.GetComponent<LuaScriptComponent>();
+        
+        if (lsc.ScriptPath.empty() || !lsc.self.valid()) {
+            return false;
+        }
+        
+        // the file is run again on the state the instance lives on, the cache only recompiles it when it has changed
+        sol::table script = lsc.Worker < 0 ? LoadScript(s_LuaState, s_ScriptCache, lsc.ScriptPath)
+                                           : LoadScript(s_Workers[lsc.Worker]->Lua, s_Workers[lsc.Worker]->Cache, lsc.ScriptPath);
+        if (!script.valid()) {
+            return false;
+        }
+        
+        // copy the new functions into the instance, its data (and owner) is kept
+        for (const auto& [key, value] : script)
         {
-            lsc.self["owner"] = std::ref(entity); // make the owner entity available to lua
+            if (value.get_type() == sol::type::function) {
+                lsc.self[key] = value;
+            }
+        }
+        
+        ResolveFunctions(lsc);
+        return true;
+    }
+
+    bool ScriptingEngine::HasScriptChanged(Entity entity)
+    {
+        const auto& lsc = entity.GetComponent<LuaScriptComponent>();
+        const ScriptCache& cache = lsc.Worker < 0 ? s_ScriptCache : s_Workers[lsc.Worker]->Cache;
+        return cache.IsStale(lsc.ScriptPath);
+    }
+
+    void ScriptingEngine::OnUpdateBatches(Scene* scene, const std::vector<std::vector<entt::entity>>& batchEntities, float ts)
+    {
+        const size_t count = std::min(batchEntities.size(), s_Batches.size());
+        
+        for (size_t i = 0; i < count; i++)
+        {
+            if (batchEntities[i].empty()) {
+                continue;
+            }
+            
+            ScriptBatch& batch = s_Batches[i];
+            batch.Begin(scene);
+            for (auto handle : batchEntities[i]) {
+                batch.Add({handle, scene});
+            }
             
-            sol::protected_function update = lsc.self["OnUpdate"];
-            if (update.valid())
+            // every instance has its own copy of the function, the one of the first entity updates them all
+            Entity first = {batchEntities[i].front(), scene};
+            const sol::protected_function& updateAll = first.GetComponent<LuaScriptComponent>().UpdateAllFunction;
+            
+            sol::protected_function_result result = updateAll(&batch, ts);
+            if (!result.valid())
             {
-                // execute script function
-                sol::protected_function_result result = update(lsc.self,ts);
-                if (!result.valid())
-                {
-                    sol::error error = result;
-                    SP_LOG_ERORR("ScriptingEngine::OnUpdate - ({0})", error.what());
-                }
+                sol::error error = result;
+                SP_LOG_ERORR("ScriptingEngine::OnUpdateAll - ({0})", error.what());
+            }
+        }
+    }
+
+    uint32_t ScriptingEngine::GetBatchCount()
+    {
+        return (uint32_t)s_Batches.size();
+    }
+
+    void ScriptingEngine::OnUpdateParallel(Scene* scene, const std::vector<std::vector<entt::entity>>& workerEntities, float ts)
+    {
+        const uint32_t count = std::min<uint32_t>((uint32_t)workerEntities.size(), GetWorkerCount());
+        
+        // a worker state is only ever used by one job, the jobs can run on any thread
+        JobSystem::ParallelFor(count, [&](uint32_t index) {
+            // component references kept by the scripts see this frame's values (the jobs only read the components)
+            s_Workers[index]->Commands.Sync();
+            
+            for (auto handle : workerEntities[index])
+            {
+                Entity entity = {handle, scene};
+                OnUpdate(entity, ts);
+            }
+        });
+        
+        // sync point, in worker order so the result doesn't depend on the scheduling
+        for (uint32_t i = 0; i < count; i++) {
+            s_Workers[i]->Commands.Flush();
+        }
+    }
+
+    void ScriptingEngine::OnRuntimeEnd()
+    {
+        for (auto& worker : s_Workers) {
+            worker->Commands.Reset();
+        }
+    }
+
+    void ScriptingEngine::SetGCSettings(const GCSettings& settings)
+    {
+        s_GCSettings = settings;
+        
+        ApplyGCMode(s_LuaState, s_LuaGC);
+        for (auto& worker : s_Workers) {
+            ApplyGCMode(worker->Lua, worker->GC);
+        }
+    }
+
+    const ScriptingEngine::GCSettings& ScriptingEngine::GetGCSettings()
+    {
+        return s_GCSettings;
+    }
+
+    void ScriptingEngine::CollectGarbage()
+    {
+        // one job per state, every state gets the whole budget (the workers are collected side by side)
+        std::vector<GCStats> stats(1 + s_Workers.size());
+        
+        JobSystem::ParallelFor((uint32_t)stats.size(), [&](uint32_t index) {
+            if (index == 0) {
+                StepGC(s_LuaState, s_LuaGC, stats[0]);
+            } else {
+                StepGC(s_Workers[index - 1]->Lua, s_Workers[index - 1]->GC, stats[index]);
             }
+        });
+        
+        s_GCStats = {};
+        for (const GCStats& state : stats)
+        {
+            s_GCStats.HeapBytes += state.HeapBytes;
+            s_GCStats.TimeMs += state.TimeMs;
+            s_GCStats.Steps += state.Steps;
+            s_GCStats.CompletedCycles += state.CompletedCycles;
         }
     }
 
-    // @TODO: OnIdle() -> lua.collect_garbage();
+    void ScriptingEngine::CollectGarbageFull()
+    {
+        s_GCStats = {};
+        
+        CollectFull(s_LuaState, s_LuaGC, s_GCStats);
+        for (auto& worker : s_Workers) {
+            CollectFull(worker->Lua, worker->GC, s_GCStats);
+        }
+        
+        SP_LOG_INFO("ScriptingEngine::CollectGarbageFull - lua heap {0} KB ({1:.2f} ms)", s_GCStats.HeapBytes / 1024, s_GCStats.TimeMs);
+    }
+
+    const ScriptingEngine::GCStats& ScriptingEngine::GetGCStats()
+    {
+        return s_GCStats;
+    }
 }
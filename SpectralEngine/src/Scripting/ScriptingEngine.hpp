@@ -4,20 +4,97 @@
 //
 //  Created by Nicolas U on 04.06.24.
 //
+#pragma once
 
 #include "pch.h"
 
 #include "sol.hpp"
 #include "Entt/Entity.hpp"
+#include "ScriptCache.hpp"
 
 namespace Spectral {
 
+    class PhysicsQuery; // fwd declaration
+
     class ScriptingEngine
     {
+    public:
+        enum class GCMode
+        {
+            Automatic = 0, // lua collects whenever it allocates, no per frame work (spikes in the middle of a frame)
+            Incremental,   // incremental steps at the end of the frame, within the budget
+            Generational   // a young collection at the end of the frame, a full one once the heap has grown too much.
+                           // Neither is split over frames, BudgetMs is not used
+        };
+        
+        // @NOTE: incremental is the default, the only mode that keeps to BudgetMs. Generational usually spends less time in
+        // total (script garbage is mostly short lived and a young collection doesn't visit the old objects, see the Scripting
+        // benchmark) but its collections can't be split: lua only goes back to generational mode with an atomic mark of the
+        // whole heap, so a major collection run as incremental steps would still end with a spike
+        struct GCSettings
+        {
+            GCMode Mode = GCMode::Incremental;
+            float BudgetMs = 1.0f;       // incremental collector time per frame and lua state, checked between the steps
+            uint32_t StepSizeKB = 16;    // work of one incremental step
+            float Pause = 1.25f;         // a new cycle (young collection) starts once the heap has grown by this factor
+            float MaxHeapGrowth = 2.5f;  // heap of the last full cycle times this: the cycle is finished regardless of the
+                                         // budget (a full collection in generational mode)
+        };
+        
+        // of the last CollectGarbage()/CollectGarbageFull(), summed over the main and the worker states
+        struct GCStats
+        {
+            size_t HeapBytes = 0;
+            double TimeMs = 0.0;         // collector time, the worker states are collected in parallel
+            uint32_t Steps = 0;
+            uint32_t CompletedCycles = 0; // full cycles, young collections only count as steps
+        };
+        
     public:
         static void Init();
         
+        // exposed to the scripts as the global "physics", pass nullptr when the runtime ends
+        static void SetPhysicsQuery(PhysicsQuery* query);
+        
+        // scripts that set Parallel = true in their table are created on one of the worker states (see OnUpdateParallel)
         static void OnCreate(Entity entity);
         static void OnUpdate(Entity entity, float ts);
+        static void OnDestroy(Entity entity);
+        
+        // runs the script file again and swaps the functions of the instance (its data is kept), false when the file fails to load
+        static bool ReloadScript(Entity entity);
+        
+        // the script file was modified since it was loaded on the state the instance lives on
+        static bool HasScriptChanged(Entity entity);
+        
+        // updates the parallel scripts, one job per worker lua state: workerEntities[i] are the entities on worker i.
+        // Their component writes are staged in the command buffer of the worker and applied once every worker is done.
+        // @NOTE: the scripts can read any component, but must not create or destroy entities
+        static void OnUpdateParallel(Scene* scene, const std::vector<std::vector<entt::entity>>& workerEntities, float ts);
+        
+        // after OnDestroy of every script: releases the staged components of the worker states (see ScriptCommandBuffer)
+        static void OnRuntimeEnd();
+        
+        // system style scripts: OnUpdateAll(entities, ts) is called once per script type with a ScriptBatch of its entities,
+        // batchEntities[i] are the entities of the script type i. Only on the main state, parallel scripts keep OnUpdate
+        static void OnUpdateBatches(Scene* scene, const std::vector<std::vector<entt::entity>>& batchEntities, float ts);
+        
+        // script types with OnUpdateAll seen so far, assigned on OnCreate (see LuaScriptComponent::Batch)
+        static uint32_t GetBatchCount();
+        
+        // worker lua states created so far, one per JobSystem thread once the first parallel script is created
+        static uint32_t GetWorkerCount();
+        
+        // the automatic collector of the lua states is stopped (except in GCMode::Automatic), the scene runs the collector
+        // once per frame with CollectGarbage() and a full collection on level transitions (OnRuntimeStart/OnRuntimeEnd)
+        static void SetGCSettings(const GCSettings& settings);
+        static const GCSettings& GetGCSettings();
+        static void CollectGarbage();
+        static void CollectGarbageFull();
+        static const GCStats& GetGCStats();
+        
+        // compiled chunks of the main and the worker states, every script file is compiled once per state
+        // (see ScriptCache, the bytecode directory is set with ScriptCache::SetBytecodeDirectory)
+        static ScriptCache::Stats GetScriptCacheStats();
     };
 }
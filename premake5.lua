@@ -96,3 +96,4 @@ group "Core"
 group "Tools"
     include ("SpectralEditor")
     include ("Sandbox")
+    include ("Benchmark")